@@ -0,0 +1,525 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: db_bench.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Measure throughput and latency percentiles of the database layer
+ * against a scratch database.
+ */
+
+#include "database.hpp"
+#include "logger.hpp"
+#include "query_stats.hpp"
+#include "scratch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct bench_options
+{
+    const char* DatabaseFile;
+    const char* SchemaFile;
+    connection_profile Profile;
+    bool StatementCache;
+    bool QueryStats;
+    int Supplies;
+    int Items;
+    int IngredientsPerItem;
+    int Orders;
+    int LinesPerOrder;
+    int Iterations;
+    int PageSize;
+    int Readers;
+};
+
+static void PrintUsage(const char* Program)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --db <path>                   Scratch database, recreated "
+            "(default: bb_bench.db)\n"
+            "  --schema <path>               Table definitions "
+            "(default: " BB_SCHEMA_FILE ")\n"
+            "  --profile <register|reporting>\n"
+            "  --journal-mode <mode>\n"
+            "  --synchronous <level>\n"
+            "  --cache-size <pages|-KiB>\n"
+            "  --statement-cache <on|off>\n"
+            "  --query-stats <on|off>        Per-query latency after the run "
+            "(default: off)\n"
+            "  --supplies <n>                (default: 200)\n"
+            "  --items <n>                   (default: 500)\n"
+            "  --ingredients <n>             Ingredients per item "
+            "(default: 3)\n"
+            "  --orders <n>                  (default: 20000)\n"
+            "  --lines <n>                   Lines per order (default: 3)\n"
+            "  --iterations <n>              Calls per operation "
+            "(default: 2000)\n"
+            "  --page-size <n>               Rows per listed page "
+            "(default: 20)\n"
+            "  --readers <n>                 Threads reading on the read-only "
+            "connections while orders are created (default: 2)\n",
+            Program);
+}
+
+static bool ParseArguments(int Argc, char** Argv, bench_options& Options)
+{
+    struct count_option
+    {
+        const char* Name;
+        int* Value;
+    };
+    const count_option Counts[] = {
+        {"--supplies",    &Options.Supplies          },
+        {"--items",       &Options.Items             },
+        {"--ingredients", &Options.IngredientsPerItem},
+        {"--orders",      &Options.Orders            },
+        {"--lines",       &Options.LinesPerOrder     },
+        {"--iterations",  &Options.Iterations        },
+        {"--page-size",   &Options.PageSize          },
+        {"--readers",     &Options.Readers           },
+    };
+
+    for (int i = 1; i < Argc; i++)
+    {
+        const char* Option = Argv[i];
+        if (i + 1 >= Argc)
+        {
+            fprintf(stderr, "Missing value for '%s'.\n", Option);
+            return false;
+        }
+
+        const char* Value = Argv[++i];
+        bool Found = false;
+        for (const count_option& Count : Counts)
+        {
+            if (strcmp(Option, Count.Name) == 0)
+            {
+                *Count.Value = atoi(Value);
+                if (*Count.Value <= 0)
+                {
+                    fprintf(stderr, "%s must be a positive integer.\n",
+                            Option);
+                    return false;
+                }
+                Found = true;
+            }
+        }
+
+        if (Found)
+        {
+            continue;
+        }
+
+        if (strcmp(Option, "--db") == 0)
+        {
+            Options.DatabaseFile = Value;
+        }
+        else if (strcmp(Option, "--schema") == 0)
+        {
+            Options.SchemaFile = Value;
+        }
+        else if (strcmp(Option, "--profile") == 0)
+        {
+            const connection_profile* Profile = FindConnectionProfile(Value);
+            if (Profile == nullptr)
+            {
+                fprintf(stderr, "Unknown connection profile '%s'.\n", Value);
+                return false;
+            }
+            Options.Profile = *Profile;
+        }
+        else if (strcmp(Option, "--journal-mode") == 0)
+        {
+            Options.Profile.JournalMode = Value;
+        }
+        else if (strcmp(Option, "--synchronous") == 0)
+        {
+            Options.Profile.Synchronous = Value;
+        }
+        else if (strcmp(Option, "--cache-size") == 0)
+        {
+            Options.Profile.CacheSize = atoi(Value);
+        }
+        else if (strcmp(Option, "--statement-cache") == 0)
+        {
+            Options.StatementCache = strcmp(Value, "off") != 0;
+        }
+        else if (strcmp(Option, "--query-stats") == 0)
+        {
+            Options.QueryStats = strcmp(Value, "off") != 0;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option '%s'.\n", Option);
+            return false;
+        }
+    }
+
+    if (Options.IngredientsPerItem > Options.Supplies ||
+        Options.LinesPerOrder > Options.Items)
+    {
+        fprintf(stderr, "--ingredients must be <= --supplies and --lines "
+                        "must be <= --items.\n");
+        return false;
+    }
+
+    return true;
+}
+
+// Distinct picks from Pool, used for the items of an order and the supplies
+// of an item since both are primary key pairs.
+static void PickDistinct(std::vector<int>& Pool, int Count,
+                         std::mt19937& Random)
+{
+    for (int i = 0; i < Count; i++)
+    {
+        std::uniform_int_distribution<size_t> Pick(i, Pool.size() - 1);
+        std::swap(Pool[i], Pool[Pick(Random)]);
+    }
+}
+
+static bool Populate(const bench_options& Options, std::vector<int>& SupplyIDs,
+                     std::vector<int>& ItemIDs, std::mt19937& Random)
+{
+    auto Start = std::chrono::steady_clock::now();
+    char Name[64];
+
+    Transaction();
+    for (int i = 0; i < Options.Supplies; i++)
+    {
+        // Enough stock that CreateOrder never runs short while measuring
+        int64_t SupplyID;
+        snprintf(Name, sizeof(Name), "Bench Supply %i", i);
+        if (!CreateSupply(Name, "units", INT_MAX / 2, &SupplyID))
+        {
+            Rollback();
+            return false;
+        }
+        SupplyIDs.push_back((int)SupplyID);
+    }
+
+    std::uniform_real_distribution<double> Amount(0.25, 4.0);
+    for (int i = 0; i < Options.Items; i++)
+    {
+        PickDistinct(SupplyIDs, Options.IngredientsPerItem, Random);
+        std::vector<ingredient> Ingredients;
+        for (int j = 0; j < Options.IngredientsPerItem; j++)
+        {
+            Ingredients.push_back({SupplyIDs[j], Amount(Random)});
+        }
+
+        int64_t ItemID;
+        snprintf(Name, sizeof(Name), "Bench Item %i", i);
+        if (!CreateItem(Name, "Benchmark item.", 2.0 + i % 7, Ingredients,
+                        &ItemID))
+        {
+            Rollback();
+            return false;
+        }
+        ItemIDs.push_back((int)ItemID);
+    }
+
+    order_importer Importer = BeginOrderImport();
+    std::uniform_int_distribution<int> Quantity(1, 4);
+    for (int i = 0; i < Options.Orders; i++)
+    {
+        PickDistinct(ItemIDs, Options.LinesPerOrder, Random);
+        std::vector<order_input> Items;
+        for (int j = 0; j < Options.LinesPerOrder; j++)
+        {
+            Items.push_back({ItemIDs[j], Quantity(Random)});
+        }
+
+        if (!ImportOrder(Importer, nullptr, Items))
+        {
+            EndOrderImport(Importer);
+            Rollback();
+            return false;
+        }
+    }
+    EndOrderImport(Importer);
+    Commit();
+
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+    printf("Populated %i supplies, %i items, %i orders (%i lines) in "
+           "%.2lfs\n\n",
+           Options.Supplies, Options.Items, Options.Orders,
+           Options.Orders * Options.LinesPerOrder, Seconds);
+    return true;
+}
+
+static double Percentile(const std::vector<double>& Sorted, double Percent)
+{
+    if (Sorted.empty())
+    {
+        return 0;
+    }
+    return Sorted[(size_t)(Percent / 100.0 * (Sorted.size() - 1) + 0.5)];
+}
+
+// Runs Operation(i) Iterations times and prints ops/sec and per-call latency
+// percentiles in microseconds. Failed calls are counted but not timed.
+template <typename function>
+static bool Measure(const char* Name, int Iterations, const function& Operation)
+{
+    std::vector<double> Latencies;
+    Latencies.reserve(Iterations);
+    int Failures = 0;
+
+    auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; i++)
+    {
+        auto CallStart = std::chrono::steady_clock::now();
+        bool Result = Operation(i);
+        auto CallEnd = std::chrono::steady_clock::now();
+
+        if (Result)
+        {
+            Latencies.push_back(
+                std::chrono::duration<double, std::micro>(CallEnd - CallStart)
+                    .count());
+        }
+        else
+        {
+            Failures++;
+        }
+    }
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+
+    std::sort(Latencies.begin(), Latencies.end());
+    printf("%-26s %10.0lf %9.1lf %9.1lf %9.1lf %9.1lf", Name,
+           Iterations / Seconds, Percentile(Latencies, 50),
+           Percentile(Latencies, 95), Percentile(Latencies, 99),
+           Latencies.empty() ? 0 : Latencies.back());
+    if (Failures > 0)
+    {
+        printf("  (%i failed)", Failures);
+    }
+    printf("\n");
+
+    return Failures == 0;
+}
+
+int main(int Argc, char** Argv)
+{
+    bench_options Options = {};
+    Options.DatabaseFile = "bb_bench.db";
+    Options.SchemaFile = BB_SCHEMA_FILE;
+    Options.Profile = RegisterProfile;
+    Options.StatementCache = true;
+    Options.Supplies = 200;
+    Options.Items = 500;
+    Options.IngredientsPerItem = 3;
+    Options.Orders = 20000;
+    Options.LinesPerOrder = 3;
+    Options.Iterations = 2000;
+    Options.PageSize = 20;
+    Options.Readers = 2;
+    if (!ParseArguments(Argc, Argv, Options))
+    {
+        PrintUsage(Argv[0]);
+        return 1;
+    }
+    Options.Profile.ReadConnections = Options.Readers;
+
+    if (!CreateScratchDatabase(Options.DatabaseFile, Options.SchemaFile) ||
+        !DatabaseInit(Options.DatabaseFile, Options.Profile))
+    {
+        return 1;
+    }
+
+    LoggerInit(CreateLogger("B&B Bench Logs", 5));
+    SetStatementCaching(Options.StatementCache);
+
+    printf("Profile %s: journal_mode=%s synchronous=%s cache_size=%i, "
+           "statement cache %s\n",
+           Options.Profile.Name, Options.Profile.JournalMode,
+           Options.Profile.Synchronous, Options.Profile.CacheSize,
+           Options.StatementCache ? "on" : "off");
+
+    // Fixed seed so runs being compared do the same work
+    std::mt19937 Random(2025);
+    std::vector<int> SupplyIDs, ItemIDs;
+    if (!Populate(Options, SupplyIDs, ItemIDs, Random))
+    {
+        PrintLogs();
+        DatabaseClose();
+        FreeLogger();
+        return 1;
+    }
+
+    // Only the measured operations
+    if (Options.QueryStats)
+    {
+        EnableQueryStats();
+    }
+    ResetQueryStats();
+    printf("%-26s %10s %9s %9s %9s %9s\n", "operation", "ops/sec", "p50 us",
+           "p95 us", "p99 us", "max us");
+
+    bool Result = true;
+    std::uniform_int_distribution<int> Quantity(1, 4);
+    std::vector<int64_t> CreatedOrders;
+    auto CreateBenchOrder = [&](int) {
+        PickDistinct(ItemIDs, Options.LinesPerOrder, Random);
+        std::vector<order_input> Items;
+        for (int j = 0; j < Options.LinesPerOrder; j++)
+        {
+            Items.push_back({ItemIDs[j], Quantity(Random)});
+        }
+
+        int64_t OrderNumber;
+        bool Created = CreateOrder(Items, &OrderNumber);
+        if (Created)
+        {
+            CreatedOrders.push_back(OrderNumber);
+        }
+        return Created;
+    };
+    Result &= Measure("CreateOrder", Options.Iterations, CreateBenchOrder);
+
+    std::uniform_int_distribution<int> AnyOrder(1, Options.Orders);
+    auto ReadPreview = [&](std::mt19937& Generator) {
+        statement Preview = GetOrderItemPreviewList(AnyOrder(Generator));
+        int Rows = 0;
+        while (Preview != nullptr && StepRow(Preview))
+        {
+            Rows++;
+        }
+        return Rows > 0;
+    };
+    Result &= Measure("GetOrderItemPreviewList", Options.Iterations,
+                      [&](int) { return ReadPreview(Random); });
+
+    // Order entry again, this time with previews running on every read-only
+    // connection at once
+    std::atomic<bool> Entering(true);
+    std::atomic<uint64_t> Previews(0);
+    std::vector<std::thread> Readers;
+    for (int r = 0; r < Options.Readers; r++)
+    {
+        Readers.emplace_back([&, r]() {
+            reader_lease Lease;
+            std::mt19937 Generator(r);
+            while (Lease && Entering && ReadPreview(Generator))
+            {
+                Previews++;
+            }
+        });
+    }
+
+    char EntryName[32];
+    snprintf(EntryName, sizeof(EntryName), "CreateOrder, %i readers",
+             Options.Readers);
+    auto ReadStart = std::chrono::steady_clock::now();
+    Result &= Measure(EntryName, Options.Iterations, CreateBenchOrder);
+    Entering = false;
+    for (std::thread& Reader : Readers)
+    {
+        Reader.join();
+    }
+    double ReadSeconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - ReadStart)
+                             .count();
+    printf("%-26s %10.0lf\n", "  previews alongside",
+           Previews / ReadSeconds);
+
+    char PageName[32];
+    snprintf(PageName, sizeof(PageName), "Order page (%i rows)",
+             Options.PageSize);
+    keyset_pager Pager = GetOrderPreviewPager();
+    SetPageSize(Pager, Options.PageSize);
+    auto ReadPage = [&]() {
+        FetchPage(Pager);
+        int Rows = 0;
+        while (StepPage(Pager))
+        {
+            Rows++;
+        }
+        return Rows;
+    };
+    Result &= Measure(PageName, Options.Iterations, [&](int) {
+        int Rows = ReadPage();
+        if (Rows == 0)
+        {
+            // The last page was exactly full, so this one is past the end
+            SetPageSize(Pager, Options.PageSize);
+            Rows = ReadPage();
+        }
+
+        // Wrap around to the first page after the last one
+        if (!NextPage(Pager))
+        {
+            SetPageSize(Pager, Options.PageSize);
+        }
+        return Rows > 0;
+    });
+    ClosePager(Pager);
+
+    Result &= Measure("DeleteOrder", (int)CreatedOrders.size(), [&](int i) {
+        return DeleteOrder((int)CreatedOrders[i]);
+    });
+
+    std::uniform_real_distribution<double> Amount(0.25, 4.0);
+    std::vector<int64_t> CreatedItems;
+    Result &= Measure("CreateItem", Options.Iterations, [&](int i) {
+        PickDistinct(SupplyIDs, Options.IngredientsPerItem, Random);
+        std::vector<ingredient> Ingredients;
+        for (int j = 0; j < Options.IngredientsPerItem; j++)
+        {
+            Ingredients.push_back({SupplyIDs[j], Amount(Random)});
+        }
+
+        char Name[64];
+        snprintf(Name, sizeof(Name), "Bench New Item %i", i);
+        int64_t ItemID;
+        bool Created = CreateItem(Name, "Benchmark item.", 3.5, Ingredients,
+                                  &ItemID);
+        if (Created)
+        {
+            CreatedItems.push_back(ItemID);
+        }
+        return Created;
+    });
+
+    Result &= Measure("DeleteItem", (int)CreatedItems.size(), [&](int i) {
+        return DeleteItem((int)CreatedItems[i]);
+    });
+
+    statement_cache_stats Stats = GetStatementCacheStats();
+    printf("\nStatement cache: %lu hits, %lu misses, %lu cached\n",
+           (unsigned long)Stats.Hits, (unsigned long)Stats.Misses,
+           (unsigned long)Stats.Cached);
+
+    if (Options.QueryStats)
+    {
+        printf("\n");
+        PrintQueryStats(stdout);
+    }
+
+    if (!Result)
+    {
+        PrintLogs();
+    }
+
+    DatabaseClose();
+    FreeLogger();
+    return Result ? 0 : 1;
+}
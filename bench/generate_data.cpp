@@ -0,0 +1,624 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: generate_data.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Generate a large, reproducible database of sales for load
+ * testing.
+ */
+
+#include "database.hpp"
+#include "logger.hpp"
+#include "scratch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+// 999 is SQLite's default bound parameter limit before 3.32, keep every
+// batched INSERT under it.
+#define BB_MAX_BOUND_PARAMETERS 999
+
+// Rows are written through a plain connection rather than the database layer,
+// so the indexes its migrations create are built once after the load instead
+// of being maintained row by row.
+static sqlite3* S_Output;
+
+struct generator_options
+{
+    const char* DatabaseFile;
+    const char* SchemaFile;
+    unsigned int Seed;
+    int Supplies;
+    int Items;
+    int Orders;
+    int Days;
+    const char* StartDate;
+    int RowsPerInsert;
+    int OrdersPerTransaction;
+};
+
+struct bound_value
+{
+    sqlite3_int64 Integer;
+    double Decimal;
+    const char* Text;
+};
+
+// Buffers rows and writes them RowsPerInsert at a time through one prepared
+// "INSERT ... VALUES (?, ?), (?, ?), ..." statement. The remainder on Flush
+// uses a statement sized to fit.
+struct batch_inserter
+{
+    std::string Table;
+    std::string Columns;
+    int ColumnCount;
+    int RowsPerInsert;
+    sqlite3_stmt* Statement;
+    std::vector<bound_value> Pending;
+    long RowsWritten;
+};
+
+static sqlite3_stmt* _PrepareInsert(const batch_inserter& Inserter, int Rows)
+{
+    std::string Row = "(";
+    for (int i = 0; i < Inserter.ColumnCount; i++)
+    {
+        Row += i == 0 ? "?" : ", ?";
+    }
+    Row += ")";
+
+    std::string Query =
+        "INSERT INTO " + Inserter.Table + " (" + Inserter.Columns + ") VALUES ";
+    for (int i = 0; i < Rows; i++)
+    {
+        Query += i == 0 ? Row : ", " + Row;
+    }
+
+    sqlite3_stmt* Statement;
+    if (sqlite3_prepare_v2(S_Output, Query.c_str(), -1, &Statement,
+                           nullptr) != SQLITE_OK)
+    {
+        BB_LOG_ERROR("Failed to prepare insert into %s: %s",
+                     Inserter.Table.c_str(), sqlite3_errmsg(S_Output));
+        return nullptr;
+    }
+    return Statement;
+}
+
+static batch_inserter CreateInserter(const char* Table, const char* Columns,
+                                     int ColumnCount, int RowsPerInsert)
+{
+    batch_inserter Inserter = {};
+    Inserter.Table = Table;
+    Inserter.Columns = Columns;
+    Inserter.ColumnCount = ColumnCount;
+    Inserter.RowsPerInsert = RowsPerInsert;
+    if (Inserter.RowsPerInsert * ColumnCount > BB_MAX_BOUND_PARAMETERS)
+    {
+        Inserter.RowsPerInsert = BB_MAX_BOUND_PARAMETERS / ColumnCount;
+    }
+
+    Inserter.Statement = _PrepareInsert(Inserter, Inserter.RowsPerInsert);
+    return Inserter;
+}
+
+static bool _WritePending(batch_inserter& Inserter, sqlite3_stmt* Statement)
+{
+    if (Statement == nullptr)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < Inserter.Pending.size(); i++)
+    {
+        const bound_value& Value = Inserter.Pending[i];
+        int Index = (int)i + 1;
+        if (Value.Text != nullptr)
+        {
+            sqlite3_bind_text(Statement, Index, Value.Text, -1, SQLITE_STATIC);
+        }
+        else if (Value.Decimal != 0)
+        {
+            sqlite3_bind_double(Statement, Index, Value.Decimal);
+        }
+        else
+        {
+            sqlite3_bind_int64(Statement, Index, Value.Integer);
+        }
+    }
+
+    bool Result = sqlite3_step(Statement) == SQLITE_DONE;
+    if (!Result)
+    {
+        BB_LOG_ERROR("Batched insert into %s failed: %s",
+                     Inserter.Table.c_str(), sqlite3_errmsg(S_Output));
+    }
+
+    sqlite3_reset(Statement);
+    Inserter.RowsWritten += Inserter.Pending.size() / Inserter.ColumnCount;
+    Inserter.Pending.clear();
+    return Result;
+}
+
+static bool AddRow(batch_inserter& Inserter,
+                   std::initializer_list<bound_value> Values)
+{
+    Inserter.Pending.insert(Inserter.Pending.end(), Values);
+    if ((int)Inserter.Pending.size() <
+        Inserter.RowsPerInsert * Inserter.ColumnCount)
+    {
+        return true;
+    }
+
+    return _WritePending(Inserter, Inserter.Statement);
+}
+
+static bool FlushInserter(batch_inserter& Inserter)
+{
+    if (Inserter.Pending.empty())
+    {
+        return true;
+    }
+
+    sqlite3_stmt* Remainder = _PrepareInsert(
+        Inserter, (int)Inserter.Pending.size() / Inserter.ColumnCount);
+    bool Result = _WritePending(Inserter, Remainder);
+    sqlite3_finalize(Remainder);
+    return Result;
+}
+
+static void CloseInserter(batch_inserter& Inserter)
+{
+    sqlite3_finalize(Inserter.Statement);
+    Inserter.Statement = nullptr;
+}
+
+static bool _Exec(const char* Query)
+{
+    char* Error = nullptr;
+    if (sqlite3_exec(S_Output, Query, nullptr, nullptr, &Error) != SQLITE_OK)
+    {
+        BB_LOG_ERROR("'%s' failed: %s", Query, Error);
+        sqlite3_free(Error);
+        return false;
+    }
+    return true;
+}
+
+static bound_value Integer(sqlite3_int64 Value)
+{
+    return {Value, 0, nullptr};
+}
+
+static bound_value Decimal(double Value)
+{
+    return {0, Value, nullptr};
+}
+
+static bound_value Text(const char* Value)
+{
+    return {0, 0, Value};
+}
+
+// Names stick to letters and spaces so generated rows stay editable through
+// the menus' input patterns. Only past the last combination is a number
+// appended.
+static std::vector<std::string> MakeNames(const char* const* Prefixes,
+                                          int PrefixCount,
+                                          const char* const* Bases,
+                                          int BaseCount, int Count)
+{
+    static const char* const Sizes[] = {"", "Large ", "Small ", "Double "};
+
+    std::vector<std::string> Names;
+    for (int i = 0; i < Count; i++)
+    {
+        int Combination = i % (PrefixCount * BaseCount * 4);
+        std::string Name = Sizes[Combination / (PrefixCount * BaseCount)];
+        Name += Prefixes[Combination / BaseCount % PrefixCount];
+        Name += Bases[Combination % BaseCount];
+        if (i >= PrefixCount * BaseCount * 4)
+        {
+            Name += " " + std::to_string(i / (PrefixCount * BaseCount * 4));
+        }
+        Names.push_back(Name);
+    }
+
+    return Names;
+}
+
+static bool GenerateCatalog(const generator_options& Options,
+                            std::mt19937& Random)
+{
+    static const char* const SupplyPrefixes[] = {
+        "", "Organic ", "Oat ", "Bulk ", "Roasted ", "Raw ", "Local ",
+    };
+    static const char* const SupplyBases[] = {
+        "Coffee Bean", "Milk",   "Sugar",    "Honey",   "Cinnamon",
+        "Vanilla",     "Cocoa",  "Caramel",  "Tea Leaf", "Cream",
+        "Nutmeg",      "Ginger", "Lavender", "Maple",    "Ice",
+    };
+    static const char* const Units[] = {"lb", "gallon", "ounce", "bag"};
+    static const char* const ItemPrefixes[] = {
+        "",        "Iced ",  "Honey ",   "Vanilla ", "Caramel ", "Cinnamon ",
+        "Maple ",  "Mocha ", "Lavender ", "Spiced ",  "Frozen ",  "House ",
+    };
+    static const char* const ItemBases[] = {
+        "Coffee", "Latte",      "Cappuccino", "Americano", "Macchiato",
+        "Mocha",  "Cold Brew",  "Chai",       "Tea",       "Espresso",
+        "Cortado", "Flat White", "Frappe",    "Cafe Miel", "Steamer",
+    };
+    const int SupplyPrefixCount = sizeof(SupplyPrefixes) / sizeof(char*);
+    const int SupplyBaseCount = sizeof(SupplyBases) / sizeof(char*);
+    const int ItemPrefixCount = sizeof(ItemPrefixes) / sizeof(char*);
+    const int ItemBaseCount = sizeof(ItemBases) / sizeof(char*);
+
+    std::vector<std::string> SupplyNames =
+        MakeNames(SupplyPrefixes, SupplyPrefixCount, SupplyBases,
+                  SupplyBaseCount, Options.Supplies);
+    std::vector<std::string> ItemNames = MakeNames(
+        ItemPrefixes, ItemPrefixCount, ItemBases, ItemBaseCount, Options.Items);
+
+    _Exec("BEGIN;");
+    batch_inserter Supplies =
+        CreateInserter("SupplyItem", "SupplyID, SupplyName, StockQuantity, "
+                                     "UnitName",
+                       4, Options.RowsPerInsert);
+    std::uniform_int_distribution<int> Stock(10000, 100000);
+    for (int i = 0; i < Options.Supplies; i++)
+    {
+        AddRow(Supplies, {Integer(i + 1), Text(SupplyNames[i].c_str()),
+                          Integer(Stock(Random)), Text(Units[i % 4])});
+    }
+
+    batch_inserter Items =
+        CreateInserter("Item", "ItemID, ItemName, ItemDescription, ItemPrice",
+                       4, Options.RowsPerInsert);
+    batch_inserter Ingredients = CreateInserter(
+        "Ingredient", "ItemID, SupplyID, Quantity", 3, Options.RowsPerInsert);
+
+    // Every recipe starts from one of the first few supplies (coffee, milk,
+    // tea...) and fans out into two to six distinct ingredients.
+    std::uniform_int_distribution<int> Price(250, 750);
+    std::uniform_int_distribution<int> FanOut(2, 6);
+    std::uniform_int_distribution<int> Base(0, SupplyBaseCount < 3 ? 0 : 2);
+    std::uniform_real_distribution<double> Amount(0.025, 2.0);
+    std::vector<int> SupplyIDs;
+    for (int i = 0; i < Options.Supplies; i++)
+    {
+        SupplyIDs.push_back(i + 1);
+    }
+
+    for (int i = 0; i < Options.Items; i++)
+    {
+        int ItemID = i + 1;
+        AddRow(Items, {Integer(ItemID), Text(ItemNames[i].c_str()),
+                       Text("Generated menu item."),
+                       Decimal(Price(Random) / 100.0)});
+
+        int Count = std::min(FanOut(Random), Options.Supplies);
+        int BaseID = Base(Random) % Options.Supplies + 1;
+        std::swap(SupplyIDs[0],
+                  *std::find(SupplyIDs.begin(), SupplyIDs.end(), BaseID));
+        for (int j = 1; j < Count; j++)
+        {
+            std::uniform_int_distribution<int> Pick(j, Options.Supplies - 1);
+            std::swap(SupplyIDs[j], SupplyIDs[Pick(Random)]);
+        }
+        for (int j = 0; j < Count; j++)
+        {
+            AddRow(Ingredients, {Integer(ItemID), Integer(SupplyIDs[j]),
+                                 Decimal(Amount(Random))});
+        }
+    }
+
+    bool Result = FlushInserter(Supplies) && FlushInserter(Items) &&
+                  FlushInserter(Ingredients);
+    _Exec(Result ? "COMMIT;" : "ROLLBACK;");
+    printf("Catalog: %li supplies, %li items, %li ingredients\n",
+           Supplies.RowsWritten, Items.RowsWritten, Ingredients.RowsWritten);
+
+    CloseInserter(Supplies);
+    CloseInserter(Items);
+    CloseInserter(Ingredients);
+    return Result;
+}
+
+// Orders per day follow the week (busier towards the weekend) and a slow
+// seasonal swing, scaled so the days add up to the requested total.
+static std::vector<int> PlanDays(const generator_options& Options,
+                                 const struct tm& Start)
+{
+    static const double Weekday[] = {1.35, 0.85, 0.9, 0.95, 1.0, 1.15, 1.45};
+    const double Pi = 3.14159265358979323846;
+
+    std::vector<double> Weights;
+    double Total = 0;
+    for (int Day = 0; Day < Options.Days; Day++)
+    {
+        double Season = 1.0 + 0.2 * sin(2 * Pi * Day / 365.0);
+        double Weight = Weekday[(Start.tm_wday + Day) % 7] * Season;
+        Weights.push_back(Weight);
+        Total += Weight;
+    }
+
+    std::vector<int> OrdersPerDay;
+    long Assigned = 0;
+    double Running = 0;
+    for (int Day = 0; Day < Options.Days; Day++)
+    {
+        Running += Weights[Day];
+        long Target = (long)(Options.Orders * Running / Total + 0.5);
+        OrdersPerDay.push_back((int)(Target - Assigned));
+        Assigned = Target;
+    }
+
+    return OrdersPerDay;
+}
+
+static bool GenerateOrders(const generator_options& Options,
+                           std::mt19937& Random)
+{
+    struct tm Start = {};
+    if (sscanf(Options.StartDate, "%d-%d-%d", &Start.tm_year, &Start.tm_mon,
+               &Start.tm_mday) != 3)
+    {
+        fprintf(stderr, "--start must be YYYY-MM-DD.\n");
+        return false;
+    }
+    Start.tm_year -= 1900;
+    Start.tm_mon -= 1;
+    Start.tm_hour = 12; // Midday so DST changes never skip a date
+    mktime(&Start);
+
+    std::vector<int> OrdersPerDay = PlanDays(Options, Start);
+
+    // Bound as SQLITE_STATIC, so every date string lives until the end
+    std::vector<std::string> Dates;
+    for (int Day = 0; Day < Options.Days; Day++)
+    {
+        char Date[16];
+        struct tm Today = Start;
+        Today.tm_mday += Day;
+        mktime(&Today);
+        strftime(Date, sizeof(Date), "%Y-%m-%d", &Today);
+        Dates.push_back(Date);
+    }
+
+    // A few items sell far more than the rest, roughly Zipf distributed
+    std::vector<double> Popularity;
+    for (int i = 0; i < Options.Items; i++)
+    {
+        Popularity.push_back(1.0 / pow(i + 1, 0.8));
+    }
+    std::discrete_distribution<int> PickItem(Popularity.begin(),
+                                             Popularity.end());
+    std::discrete_distribution<int> LineCount({0, 55, 28, 12, 5});
+    std::discrete_distribution<int> Quantity({0, 80, 15, 5});
+
+    batch_inserter Orders = CreateInserter(
+        "MenuOrder", "OrderNumber, OrderDate", 2, Options.RowsPerInsert);
+    batch_inserter Lines =
+        CreateInserter("MenuOrderItem", "OrderNumber, ItemID, OrderQuantity",
+                       3, Options.RowsPerInsert);
+
+    bool Result = true;
+    int OrderNumber = 0;
+    int OrdersInTransaction = 0;
+    int OrderItems[4];
+
+    _Exec("BEGIN;");
+    for (int Day = 0; Result && Day < Options.Days; Day++)
+    {
+        for (int i = 0; Result && i < OrdersPerDay[Day]; i++)
+        {
+            OrderNumber++;
+            Result &= AddRow(Orders, {Integer(OrderNumber),
+                                      Text(Dates[Day].c_str())});
+
+            int Count = std::min(LineCount(Random), Options.Items);
+            for (int j = 0; j < Count; j++)
+            {
+                // Redraw rather than repeat an item already on the order
+                int ItemID;
+                bool Repeated;
+                do
+                {
+                    ItemID = PickItem(Random) + 1;
+                    Repeated = false;
+                    for (int k = 0; k < j; k++)
+                    {
+                        Repeated |= OrderItems[k] == ItemID;
+                    }
+                } while (Repeated);
+
+                OrderItems[j] = ItemID;
+                Result &= AddRow(Lines, {Integer(OrderNumber), Integer(ItemID),
+                                         Integer(Quantity(Random))});
+            }
+
+            if (++OrdersInTransaction == Options.OrdersPerTransaction)
+            {
+                Result &= FlushInserter(Orders) && FlushInserter(Lines) &&
+                          _Exec("COMMIT; BEGIN;");
+                OrdersInTransaction = 0;
+            }
+        }
+    }
+
+    Result &= FlushInserter(Orders) && FlushInserter(Lines);
+    _Exec(Result ? "COMMIT;" : "ROLLBACK;");
+
+    printf("Sales: %li orders, %li order lines over %i days from %s\n",
+           Orders.RowsWritten, Lines.RowsWritten, Options.Days,
+           Options.StartDate);
+
+    CloseInserter(Orders);
+    CloseInserter(Lines);
+    return Result;
+}
+
+static void PrintUsage(const char* Program)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --db <path>               Output database, recreated "
+            "(default: generated.db)\n"
+            "  --schema <path>           Table definitions "
+            "(default: " BB_SCHEMA_FILE ")\n"
+            "  --seed <n>                Random seed (default: 1)\n"
+            "  --supplies <n>            (default: 120)\n"
+            "  --items <n>               (default: 300)\n"
+            "  --orders <n>              (default: 1000000)\n"
+            "  --days <n>                Days of sales (default: 365)\n"
+            "  --start <YYYY-MM-DD>      First sales day "
+            "(default: 2025-01-01)\n"
+            "  --rows-per-insert <n>     Rows per INSERT statement "
+            "(default: 256)\n"
+            "  --orders-per-commit <n>   (default: 100000)\n",
+            Program);
+}
+
+static bool ParseArguments(int Argc, char** Argv, generator_options& Options)
+{
+    struct count_option
+    {
+        const char* Name;
+        int* Value;
+    };
+    const count_option Counts[] = {
+        {"--supplies",          &Options.Supplies            },
+        {"--items",             &Options.Items               },
+        {"--orders",            &Options.Orders              },
+        {"--days",              &Options.Days                },
+        {"--rows-per-insert",   &Options.RowsPerInsert       },
+        {"--orders-per-commit", &Options.OrdersPerTransaction},
+    };
+
+    for (int i = 1; i < Argc; i++)
+    {
+        const char* Option = Argv[i];
+        if (i + 1 >= Argc)
+        {
+            fprintf(stderr, "Missing value for '%s'.\n", Option);
+            return false;
+        }
+
+        const char* Value = Argv[++i];
+        bool Found = false;
+        for (const count_option& Count : Counts)
+        {
+            if (strcmp(Option, Count.Name) == 0)
+            {
+                *Count.Value = atoi(Value);
+                if (*Count.Value <= 0)
+                {
+                    fprintf(stderr, "%s must be a positive integer.\n",
+                            Option);
+                    return false;
+                }
+                Found = true;
+            }
+        }
+
+        if (Found)
+        {
+            continue;
+        }
+
+        if (strcmp(Option, "--db") == 0)
+        {
+            Options.DatabaseFile = Value;
+        }
+        else if (strcmp(Option, "--schema") == 0)
+        {
+            Options.SchemaFile = Value;
+        }
+        else if (strcmp(Option, "--seed") == 0)
+        {
+            Options.Seed = (unsigned int)strtoul(Value, nullptr, 10);
+        }
+        else if (strcmp(Option, "--start") == 0)
+        {
+            Options.StartDate = Value;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option '%s'.\n", Option);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int Argc, char** Argv)
+{
+    generator_options Options = {};
+    Options.DatabaseFile = "generated.db";
+    Options.SchemaFile = BB_SCHEMA_FILE;
+    Options.Seed = 1;
+    Options.Supplies = 120;
+    Options.Items = 300;
+    Options.Orders = 1000000;
+    Options.Days = 365;
+    Options.StartDate = "2025-01-01";
+    Options.RowsPerInsert = 256;
+    Options.OrdersPerTransaction = 100000;
+    if (!ParseArguments(Argc, Argv, Options))
+    {
+        PrintUsage(Argv[0]);
+        return 1;
+    }
+
+    if (!CreateScratchDatabase(Options.DatabaseFile, Options.SchemaFile) ||
+        sqlite3_open(Options.DatabaseFile, &S_Output) != SQLITE_OK)
+    {
+        return 1;
+    }
+
+    LoggerInit(CreateLogger("B&B Generator Logs", 5));
+    printf("Generating %s with seed %u\n", Options.DatabaseFile, Options.Seed);
+    auto Start = std::chrono::steady_clock::now();
+
+    // The file is rebuilt from scratch on failure, so durability is traded
+    // for speed while generating
+    std::mt19937 Random(Options.Seed);
+    bool Result = _Exec("PRAGMA journal_mode = OFF;"
+                        "PRAGMA synchronous = OFF;"
+                        "PRAGMA cache_size = -262144;") &&
+                  GenerateCatalog(Options, Random) &&
+                  GenerateOrders(Options, Random);
+    sqlite3_close(S_Output);
+
+    // Opening through the database layer applies the migrations, which adds
+    // the indexes now that the rows are in
+    Result = Result && DatabaseInit(Options.DatabaseFile, RegisterProfile);
+
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+    if (Result)
+    {
+        printf("Done in %.2lfs\n", Seconds);
+    }
+    else
+    {
+        PrintLogs();
+    }
+
+    DatabaseClose();
+    FreeLogger();
+    return Result ? 0 : 1;
+}
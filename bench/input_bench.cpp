@@ -0,0 +1,111 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: input_bench.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Compare the input_pattern matchers against the std::regex
+ * validation they replaced.
+ */
+
+#include "input.hpp"
+#include <chrono>
+#include <regex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static const std::vector<std::string> Inputs = {
+    "Iced Honey Cinnamon Coffee",
+    "Black Coffee",
+    "-1",
+    "lb",
+    "Coffee served with steamed almond milk, honey, and cinnamon.",
+    "Caf3 M1el",
+    "",
+    "A very long item name made only of letters and spaces to stress the loop",
+};
+
+// The old ReadString took the regex by value, copying it on every call
+static bool MatchRegexByValue(const std::string& Input, std::regex Pattern)
+{
+    return std::regex_match(Input, Pattern);
+}
+
+template <typename function>
+static double TimePerCall(const char* Name, int Iterations,
+                          const function& Match)
+{
+    long Matches = 0;
+    auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Iterations; i++)
+    {
+        for (const std::string& Input : Inputs)
+        {
+            Matches += Match(Input);
+        }
+    }
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+
+    double Nanoseconds = Seconds * 1e9 / ((double)Iterations * Inputs.size());
+    printf("%-28s %10.1lf ns/match  (%li matches)\n", Name, Nanoseconds,
+           Matches);
+    return Nanoseconds;
+}
+
+int main(int Argc, char** Argv)
+{
+    int Iterations = Argc > 1 ? atoi(Argv[1]) : 100000;
+
+    const std::regex NameRegex("^([A-Za-z ]+|-1)$");
+    const std::regex DescriptionRegex("^([A-Za-z .,]+|-1)$");
+
+    // Both paths must agree before their timings mean anything
+    for (const std::string& Input : Inputs)
+    {
+        if (std::regex_match(Input, NameRegex) !=
+                MatchPattern(Input, NamePattern) ||
+            std::regex_match(Input, DescriptionRegex) !=
+                MatchPattern(Input, DescriptionPattern))
+        {
+            fprintf(stderr, "Matchers disagree on '%s'\n", Input.c_str());
+            return 1;
+        }
+    }
+
+    printf("%i iterations over %zu inputs\n", Iterations, Inputs.size());
+
+    double PerCopy = TimePerCall(
+        "regex, copied per call", Iterations / 10,
+        [&](const std::string& Input) {
+            return MatchRegexByValue(Input, NameRegex);
+        });
+    double PerRegex =
+        TimePerCall("regex, by reference", Iterations,
+                    [&](const std::string& Input) {
+                        return std::regex_match(Input, NameRegex);
+                    });
+    double PerConstruct = TimePerCall(
+        "regex, constructed per call", Iterations / 100,
+        [&](const std::string& Input) {
+            return std::regex_match(Input,
+                                    std::regex("^([A-Za-z .,]+|-1)$"));
+        });
+    double PerPattern =
+        TimePerCall("input_pattern", Iterations,
+                    [&](const std::string& Input) {
+                        return MatchPattern(Input, NamePattern);
+                    });
+
+    printf("\ninput_pattern is %.1lfx faster than a shared regex, %.1lfx than "
+           "a copied one and %.1lfx than one built per call\n",
+           PerRegex / PerPattern, PerCopy / PerPattern,
+           PerConstruct / PerPattern);
+    return 0;
+}
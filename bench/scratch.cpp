@@ -0,0 +1,57 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: scratch.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Create throwaway databases for the benchmark tools.
+ */
+
+#include "scratch.hpp"
+#include "sqlite3.h"
+#include <stdio.h>
+#include <string>
+
+bool CreateScratchDatabase(const char* FileName, const char* SchemaFile)
+{
+    FILE* Schema = fopen(SchemaFile, "rb");
+    if (Schema == nullptr)
+    {
+        fprintf(stderr, "Failed to open schema '%s'.\n", SchemaFile);
+        return false;
+    }
+
+    std::string Script;
+    char Buffer[4096];
+    size_t Read;
+    while ((Read = fread(Buffer, 1, sizeof(Buffer), Schema)) > 0)
+    {
+        Script.append(Buffer, Read);
+    }
+    fclose(Schema);
+
+    remove(FileName);
+    std::string Journal = std::string(FileName) + "-wal";
+    remove(Journal.c_str());
+    Journal = std::string(FileName) + "-shm";
+    remove(Journal.c_str());
+
+    sqlite3* Scratch;
+    char* Error = nullptr;
+    bool Result =
+        sqlite3_open(FileName, &Scratch) == SQLITE_OK &&
+        sqlite3_exec(Scratch, Script.c_str(), nullptr, nullptr, &Error) ==
+            SQLITE_OK;
+    if (!Result)
+    {
+        fprintf(stderr, "Failed to create '%s': %s\n", FileName,
+                Error ? Error : sqlite3_errmsg(Scratch));
+    }
+
+    sqlite3_free(Error);
+    sqlite3_close(Scratch);
+    return Result;
+}
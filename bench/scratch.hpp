@@ -0,0 +1,22 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: scratch.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Create throwaway databases for the benchmark tools.
+ */
+
+#pragma once
+
+#ifndef BB_SCHEMA_FILE
+#define BB_SCHEMA_FILE "database/tables.sql"
+#endif
+
+// DatabaseInit only opens existing databases, so scratch files are created
+// here from the same table definitions setup.sql reads. Any existing file and
+// its WAL are removed first.
+bool CreateScratchDatabase(const char* FileName, const char* SchemaFile);
@@ -0,0 +1,254 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: archive.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Move old orders out of the working database.
+ */
+
+#include "archive.hpp"
+#include "database.hpp"
+#include "logger.hpp"
+#include <chrono>
+#include <stdio.h>
+
+static bool _Exec(const char* Query)
+{
+    char* Error = nullptr;
+    if (sqlite3_exec(DatabaseHandle(), Query, nullptr, nullptr, &Error) !=
+        SQLITE_OK)
+    {
+        BB_LOG_ERROR("Archive query failed. (%s)", Error);
+        sqlite3_free(Error);
+        return false;
+    }
+
+    return true;
+}
+
+// ATTACH/DETACH and VACUUM take a file name, which is bound rather than
+// pasted into the SQL.
+static bool _ExecWithFile(const char* Query, const char* FileName)
+{
+    statement Statement(Prepare(Query));
+    if (Statement == nullptr)
+    {
+        return false;
+    }
+
+    statement_binder(Statement).text(FileName);
+    bool Result = sqlite3_step(Statement) == SQLITE_DONE;
+    if (!Result)
+    {
+        BB_LOG_ERROR("'%s' failed for '%s'. (%s)", Query, FileName,
+                     sqlite3_errmsg(DatabaseHandle()));
+    }
+
+    return Result;
+}
+
+static const char S_ArchiveSchema[] = R"(
+    CREATE TABLE IF NOT EXISTS Archive.MenuOrder (
+        OrderNumber INTEGER NOT NULL PRIMARY KEY,
+        OrderDate   TEXT    NOT NULL
+    );
+
+    CREATE TABLE IF NOT EXISTS Archive.MenuOrderItem (
+        OrderNumber   INTEGER NOT NULL,
+        ItemID        INTEGER NOT NULL,
+        OrderQuantity INTEGER NOT NULL,
+        ItemName      TEXT,
+        ItemPrice     FLOAT,
+
+        PRIMARY KEY(OrderNumber, ItemID)
+    ) WITHOUT ROWID;
+
+    CREATE INDEX IF NOT EXISTS Archive.ArchivedOrderByDate
+        ON MenuOrder(OrderDate);
+
+    CREATE TEMP TABLE IF NOT EXISTS ArchiveKeys (Key INTEGER PRIMARY KEY);
+)";
+
+// One batch: pick the next OrdersPerTransaction old orders, copy them with
+// their lines into the archive and delete them from the working tables. An
+// order number already in the archive fails the batch rather than replacing
+// what was archived under it.
+// The statements are compiled per run rather than cached, since they refer
+// to the attached schema and must be gone before DETACH.
+enum archive_step
+{
+    ARCHIVE_STEP_SELECT,
+    ARCHIVE_STEP_COPY_ORDERS,
+    ARCHIVE_STEP_COPY_LINES,
+    ARCHIVE_STEP_DELETE_LINES,
+    ARCHIVE_STEP_DELETE_ORDERS,
+    ARCHIVE_STEP_CLEAR,
+    ARCHIVE_STEP_COUNT,
+};
+
+static const char* const S_ArchiveSteps[ARCHIVE_STEP_COUNT] = {
+    R"(
+        INSERT INTO temp.ArchiveKeys
+        SELECT OrderNumber
+        FROM main.MenuOrder
+        WHERE OrderDate < ?
+        ORDER BY OrderNumber
+        LIMIT ?
+    )",
+    R"(
+        INSERT INTO Archive.MenuOrder
+        SELECT OrderNumber, OrderDate
+        FROM main.MenuOrder
+        WHERE OrderNumber IN (SELECT Key FROM temp.ArchiveKeys)
+    )",
+    R"(
+        INSERT INTO Archive.MenuOrderItem
+        SELECT
+        MenuOrderItem.OrderNumber,
+        MenuOrderItem.ItemID,
+        MenuOrderItem.OrderQuantity,
+        Item.ItemName,
+        coalesce(MenuOrderItem.UnitPrice, Item.ItemPrice)
+        FROM main.MenuOrderItem
+        LEFT JOIN main.Item ON Item.ItemID = MenuOrderItem.ItemID
+        WHERE MenuOrderItem.OrderNumber IN (SELECT Key FROM temp.ArchiveKeys)
+    )",
+    R"(
+        DELETE FROM main.MenuOrderItem
+        WHERE OrderNumber IN (SELECT Key FROM temp.ArchiveKeys)
+    )",
+    R"(
+        DELETE FROM main.MenuOrder
+        WHERE OrderNumber IN (SELECT Key FROM temp.ArchiveKeys)
+    )",
+    "DELETE FROM temp.ArchiveKeys",
+};
+
+bool ArchiveOrders(const char* ArchiveFile, const char* Before,
+                   int OrdersPerTransaction)
+{
+    auto Start = std::chrono::steady_clock::now();
+
+    // ATTACH opens with the main connection's flags, which don't include
+    // SQLITE_OPEN_CREATE, so a new archive file is created here first
+    sqlite3* Created = nullptr;
+    int Opened = sqlite3_open_v2(ArchiveFile, &Created,
+                                 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+                                 nullptr);
+    if (Opened != SQLITE_OK)
+    {
+        BB_LOG_ERROR("Failed to create the archive '%s'. (%s)", ArchiveFile,
+                     sqlite3_errmsg(Created));
+    }
+    sqlite3_close_v2(Created);
+
+    if (Opened != SQLITE_OK ||
+        !_ExecWithFile("ATTACH DATABASE ? AS Archive", ArchiveFile))
+    {
+        return false;
+    }
+
+    statement Steps[ARCHIVE_STEP_COUNT];
+    bool Result = _Exec(S_ArchiveSchema);
+    for (int i = 0; Result && i < ARCHIVE_STEP_COUNT; i++)
+    {
+        Steps[i] = statement(Prepare(S_ArchiveSteps[i]));
+        Result = Steps[i] != nullptr;
+    }
+
+    long Orders = 0;
+    long Lines = 0;
+    long Batches = 0;
+    while (Result)
+    {
+        Transaction();
+
+        statement_binder(Steps[ARCHIVE_STEP_SELECT])
+            .text(Before)
+            .integer(OrdersPerTransaction);
+
+        int BatchOrders = 0;
+        int BatchLines = 0;
+        for (int i = 0; Result && i < ARCHIVE_STEP_COUNT; i++)
+        {
+            Result = sqlite3_step(Steps[i]) == SQLITE_DONE;
+            sqlite3_reset(Steps[i]);
+
+            if (i == ARCHIVE_STEP_SELECT)
+            {
+                BatchOrders = sqlite3_changes(DatabaseHandle());
+            }
+            else if (i == ARCHIVE_STEP_DELETE_LINES)
+            {
+                BatchLines = sqlite3_changes(DatabaseHandle());
+            }
+        }
+
+        if (!Result)
+        {
+            BB_LOG_ERROR("Failed to archive a batch of orders. (%s)",
+                         sqlite3_errmsg(DatabaseHandle()));
+            Rollback();
+            break;
+        }
+
+        Commit();
+        if (BatchOrders == 0)
+        {
+            break;
+        }
+
+        Orders += BatchOrders;
+        Lines += BatchLines;
+        Batches++;
+    }
+
+    for (statement& Step : Steps)
+    {
+        ReleaseStatement(Step);
+    }
+    _Exec("DETACH DATABASE Archive");
+
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+    printf("Archived %li orders (%li lines) before %s into '%s' in %li "
+           "transactions, %.2lfs\n",
+           Orders, Lines, Before, ArchiveFile, Batches, Seconds);
+    return Result;
+}
+
+bool CompactDatabase(const char* Into)
+{
+    auto Start = std::chrono::steady_clock::now();
+
+    bool Result;
+    if (Into != nullptr)
+    {
+        Result = _ExecWithFile("VACUUM INTO ?", Into);
+    }
+    else
+    {
+        // auto_vacuum 2 is INCREMENTAL
+        statement Statement = AcquireStatement("PRAGMA auto_vacuum");
+        bool Incremental = Statement != nullptr && StepRow(Statement) &&
+                           row_reader(Statement).integer() == 2;
+        ReleaseStatement(Statement);
+
+        Result = _Exec(Incremental ? "PRAGMA incremental_vacuum" : "VACUUM");
+    }
+
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+    if (Result)
+    {
+        printf("Compacted %s in %.2lfs\n", Into ? Into : "the database",
+               Seconds);
+    }
+    return Result;
+}
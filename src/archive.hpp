@@ -0,0 +1,33 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: archive.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Move old orders out of the working database.
+ */
+
+#pragma once
+
+/*
+ * Moves every order dated before Before ('YYYY-MM-DD', exclusive) and its
+ * lines into ArchiveFile, which is created if needed and attached for the
+ * duration. Archived lines keep a copy of the item's name and price so they
+ * stay readable after the item is deleted.
+ *
+ * Orders move OrdersPerTransaction at a time, each batch committing on its
+ * own so the register is never blocked for long. A failure rolls back only
+ * the batch in progress. DailyItemSales/DailyOrders are left alone, so the
+ * reports still cover archived days.
+ */
+bool ArchiveOrders(const char* ArchiveFile, const char* Before,
+                   int OrdersPerTransaction);
+
+// Gives the space freed by archiving back to the file system, false if that
+// failed. With Into set the database is instead written compacted to that new
+// file (VACUUM INTO) and left as it is. Incremental auto-vacuum databases only
+// release their free pages, others are rebuilt with VACUUM.
+bool CompactDatabase(const char* Into);
@@ -11,21 +11,30 @@
  * inventory.
  */
 
+#include "archive.hpp"
+#include "catalog.hpp"
+#include "commands.hpp"
 #include "database.hpp"
+#include "import.hpp"
 #include "input.hpp"
 #include "logger.hpp"
+#include "query_stats.hpp"
+#include "reports.hpp"
+#include "service.hpp"
+#include "terminal.hpp"
 #include <assert.h>
 #include <functional>
-#include <regex>
+#include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <string>
 #include <unistd.h>
 #include <vector>
 
-std::regex LettersOnlyRegex("^([A-Za-z ]+|-1)$");
-
 static int
-GetPagingSelection(sqlite3_stmt* QueryList, int QueryListCount,
+GetPagingSelection(keyset_pager& Pager, int QueryListCount,
                    const char* RowName,
                    const std::function<void(row_reader)>& RowPrintFunction,
                    const std::function<void()>& SelectionText,
@@ -48,7 +57,7 @@ GetPagingSelection(sqlite3_stmt* QueryList, int QueryListCount,
         return -1;
     }
 
-    int Page = 0;
+    SetPageSize(Pager, RowsPerPage);
     while (true)
     {
         ClearScreen();
@@ -58,9 +67,10 @@ GetPagingSelection(sqlite3_stmt* QueryList, int QueryListCount,
         printf("(-2 to cancel, 0 to go to the next "
                "page, -1 to go back a page)\n");
 
-        for (int i = 0; i < RowsPerPage && StepRow(QueryList); i++)
+        FetchPage(Pager);
+        for (int i = 0; i < RowsPerPage && StepPage(Pager); i++)
         {
-            RowPrintFunction(row_reader(QueryList));
+            RowPrintFunction(row_reader(Pager.Statement));
         }
 
         printf(">> ");
@@ -74,17 +84,14 @@ GetPagingSelection(sqlite3_stmt* QueryList, int QueryListCount,
         }
         else if (Choice == 0)
         {
-            if ((Page * RowsPerPage) + RowsPerPage < QueryListCount)
+            if ((Pager.Page * RowsPerPage) + RowsPerPage < QueryListCount)
             {
-                Page++;
+                NextPage(Pager);
             }
         }
         else if (Choice == -1)
         {
-            if (Page > 0)
-            {
-                Page--;
-            }
+            PreviousPage(Pager);
         }
         else
         {
@@ -93,13 +100,6 @@ GetPagingSelection(sqlite3_stmt* QueryList, int QueryListCount,
                 return Choice;
             }
         }
-
-        // Reset to updated page
-        sqlite3_reset(QueryList);
-        for (int i = 0; i < Page * RowsPerPage; i++)
-        {
-            StepRow(QueryList);
-        }
     }
 
     assert(true && "Never should reach this point.");
@@ -107,6 +107,8 @@ GetPagingSelection(sqlite3_stmt* QueryList, int QueryListCount,
 
 void ShowAddItemMenu()
 {
+    RefreshCatalog();
+
     std::string ItemName;
     while (true)
     {
@@ -116,7 +118,7 @@ void ShowAddItemMenu()
         printf("What is the name of the new item? (-1 to cancel)\n");
         printf(">> ");
 
-        if (ReadString(ItemName, LettersOnlyRegex))
+        if (ReadString(ItemName, NamePattern))
         {
             break;
         }
@@ -151,33 +153,24 @@ void ShowAddItemMenu()
             }
         }
 
-        sqlite3_stmt* SupplyItem = GetSupplyItem(SupplyID);
-        sqlite3_finalize(SupplyItem);
-        return SupplyItem != nullptr;
+        return FindCatalogSupply(SupplyID) != nullptr;
     };
 
-    sqlite3_stmt* SupplyList = GetSupplyList();
+    keyset_pager SupplyPager = GetSupplyPager();
     int SupplyCount = GetSupplyCount();
     while (true)
     {
-        sqlite3_reset(SupplyList);
-
         int SupplyID = GetPagingSelection(
-            SupplyList, SupplyCount, "supply", SupplyPrintFunction,
+            SupplyPager, SupplyCount, "supply", SupplyPrintFunction,
             SupplySelectionText, SupplyValidation);
 
         if (SupplyID == -1)
         {
-            sqlite3_finalize(SupplyList);
+            ClosePager(SupplyPager);
             return;
         }
 
-        sqlite3_stmt* SupplyItem = GetSupplyItem(SupplyID);
-        row_reader Reader(SupplyItem);
-        Reader.integer(); // Skip ID
-        const char* SupplyName = Reader.text();
-        Reader.integer(); // Skip Quantity
-        const char* SupplyUnitName = Reader.text();
+        const catalog_supply* Supply = FindCatalogSupply(SupplyID);
 
         double IngredientQuantity;
         while (true)
@@ -187,7 +180,7 @@ void ShowAddItemMenu()
 
             printf("How much of '%s' does this item use? (Units: %s) (eg. "
                    "'1.5')\n",
-                   SupplyName, SupplyUnitName);
+                   Supply->Name.c_str(), Supply->UnitName.c_str());
             printf(">> ");
 
             if (ReadPositiveDouble(IngredientQuantity))
@@ -197,7 +190,6 @@ void ShowAddItemMenu()
 
             BB_LOG_ERROR("Quantity must be a positive value");
         }
-        sqlite3_finalize(SupplyItem);
 
         Ingredients.push_back(
             {.SupplyID = SupplyID, .Quantity = IngredientQuantity});
@@ -233,7 +225,7 @@ void ShowAddItemMenu()
                ItemName.c_str());
         printf(">> ");
 
-        if (ReadString(ItemDescription, std::regex("^([A-Za-z .,]+|-1)$")))
+        if (ReadString(ItemDescription, DescriptionPattern))
         {
             break;
         }
@@ -264,14 +256,15 @@ void ShowAddItemMenu()
         BB_LOG_ERROR("Invalid item price. Expected postive decimal > 0.");
     }
 
+    int64_t ItemID;
     if (CreateItem(ItemName.c_str(), ItemDescription.c_str(), ItemPrice,
-                   Ingredients))
+                   Ingredients, &ItemID))
     {
-        int64_t ItemID = LastInsertRowID();
-        BB_LOG_INFO("Item '%s' created with ID: %i", ItemName.c_str(), ItemID);
+        BB_LOG_INFO("Item '%s' created with ID: %" PRId64, ItemName.c_str(),
+                    ItemID);
     }
 
-    sqlite3_finalize(SupplyList);
+    ClosePager(SupplyPager);
 }
 
 void ShowAddSupplyMenu()
@@ -285,7 +278,7 @@ void ShowAddSupplyMenu()
         printf("What is the name of the new supply? (-1 to cancel)\n");
         printf(">> ");
 
-        if (ReadString(SupplyName, LettersOnlyRegex))
+        if (ReadString(SupplyName, NamePattern))
         {
             break;
         }
@@ -309,7 +302,7 @@ void ShowAddSupplyMenu()
                "cancel)\n");
         printf(">> ");
 
-        if (ReadString(UnitName, LettersOnlyRegex))
+        if (ReadString(UnitName, UnitPattern))
         {
             break;
         }
@@ -347,16 +340,19 @@ void ShowAddSupplyMenu()
         return;
     }
 
-    if (CreateSupply(SupplyName.c_str(), UnitName.c_str(), Quantity))
+    int64_t SupplyID;
+    if (CreateSupply(SupplyName.c_str(), UnitName.c_str(), Quantity,
+                     &SupplyID))
     {
-        int64_t SupplyID = LastInsertRowID();
-        BB_LOG_INFO("Created supply '%s' with ID: %i", SupplyName.c_str(),
-                    SupplyID);
+        BB_LOG_INFO("Created supply '%s' with ID: %" PRId64,
+                    SupplyName.c_str(), SupplyID);
     }
 }
 
 void ShowAddOrderMenu()
 {
+    RefreshCatalog();
+
     int MenuItemCount = GetItemCount();
     if (MenuItemCount == 0)
     {
@@ -390,19 +386,16 @@ void ShowAddOrderMenu()
             }
         }
 
-        sqlite3_stmt* Item = GetItem(ItemID);
-        sqlite3_finalize(Item);
-        return Item != nullptr;
+        return FindCatalogItem(ItemID) != nullptr;
     };
 
-    sqlite3_stmt* MenuItemList = GetItemList();
+    keyset_pager MenuItemPager = GetItemPager();
     while (true)
     {
         ClearScreen();
         PrintLogs();
 
-        sqlite3_reset(MenuItemList);
-        int ItemChoice = GetPagingSelection(MenuItemList, MenuItemCount,
+        int ItemChoice = GetPagingSelection(MenuItemPager, MenuItemCount,
                                             "items", ItemPrintCallback,
                                             ItemSelectionText, ItemValidation);
 
@@ -411,8 +404,7 @@ void ShowAddOrderMenu()
             break;
         }
 
-        sqlite3_stmt* Item = GetItem(ItemChoice);
-        const char* ItemName = row_reader(Item, 1).text();
+        const catalog_item* Item = FindCatalogItem(ItemChoice);
 
         int Quantity;
         while (true)
@@ -420,7 +412,7 @@ void ShowAddOrderMenu()
             ClearScreen();
             PrintLogs();
 
-            printf("Quantity for %s:\n", ItemName);
+            printf("Quantity for %s:\n", Item->Name.c_str());
             printf(">> ");
 
             if (ReadInt(Quantity))
@@ -432,7 +424,6 @@ void ShowAddOrderMenu()
                 BB_LOG_ERROR("Quantity must be a positive integer > 0.");
             }
         }
-        sqlite3_finalize(Item);
 
         ItemsForOrder.push_back({.ItemID = ItemChoice, .Quantity = Quantity});
         bool AddAnotherItem;
@@ -450,18 +441,16 @@ void ShowAddOrderMenu()
             }
         }
 
-        if (!AddAnotherItem && CreateOrder(ItemsForOrder))
+        int64_t OrderNumber;
+        if (!AddAnotherItem && CreateOrder(ItemsForOrder, &OrderNumber))
         {
-            int64_t OrderNumber = LastInsertRowID();
-            BB_LOG_INFO("Order created with ID: %li", OrderNumber);
+            BB_LOG_INFO("Order created with ID: %" PRId64, OrderNumber);
 
             break;
         }
-
-        sqlite3_finalize(MenuItemList);
     }
 
-    sqlite3_finalize(MenuItemList);
+    ClosePager(MenuItemPager);
 }
 
 void ShowAddMenu(bool& ShouldExit)
@@ -504,37 +493,25 @@ int GetOrderSelection()
 
     auto OrderPrintCallback = [](row_reader Reader) {
         int OrderNumber = Reader.integer();
-        sqlite3_stmt* PreviewList = GetOrderItemPreviewList(OrderNumber);
+        Reader.text(); // Skip OrderDate
+        const char* Preview = Reader.text();
 
-        printf("#%i | ", OrderNumber);
-        while (StepRow(PreviewList))
-        {
-            row_reader Reader(PreviewList);
-            int OrderQuantity = Reader.integer();
-            Reader.integer();
-            const char* ItemName = Reader.text();
-
-            printf("x%i - %s ", OrderQuantity, ItemName);
-        }
-        printf("\n");
-
-        sqlite3_finalize(PreviewList);
+        printf("#%i | %s\n", OrderNumber, Preview ? Preview : "");
     };
 
     auto OrderSelectionText = []() { printf("Select an order to update.\n"); };
 
     auto OrderValidation = [](int OrderNumber) {
-        sqlite3_stmt* Order = GetOrder(OrderNumber);
-        sqlite3_finalize(Order);
+        statement Order = GetOrder(OrderNumber);
         return Order != nullptr;
     };
 
-    sqlite3_stmt* OrderList = GetOrderList();
-    int OrderNumber = GetPagingSelection(OrderList, GetOrderCount(), "order",
+    keyset_pager OrderPager = GetOrderPreviewPager();
+    int OrderNumber = GetPagingSelection(OrderPager, GetOrderCount(), "order",
                                          OrderPrintCallback, OrderSelectionText,
                                          OrderValidation);
 
-    sqlite3_finalize(OrderList);
+    ClosePager(OrderPager);
     return OrderNumber;
 }
 
@@ -555,16 +532,16 @@ int GetOrderItemSelection(int OrderNumber)
     auto SelectionText = []() { printf("Select an item to update.\n"); };
 
     auto OrderItemValidation = [&](int ItemID) {
-        sqlite3_stmt* OrderItem = GetOrderItem(OrderNumber, ItemID);
-        sqlite3_finalize(OrderItem);
+        statement OrderItem = GetOrderItem(OrderNumber, ItemID);
         return OrderItem != nullptr;
     };
 
-    sqlite3_stmt* PreviewList = GetOrderItemPreviewList(OrderNumber);
+    keyset_pager PreviewPager = GetOrderItemPreviewPager(OrderNumber);
     OrderItemID = GetPagingSelection(
-        PreviewList, GetOrderItemCount(OrderNumber), "order item",
+        PreviewPager, GetOrderItemCount(OrderNumber), "order item",
         OrderItemCallback, SelectionText, OrderItemValidation);
 
+    ClosePager(PreviewPager);
     return OrderItemID;
 }
 
@@ -585,17 +562,15 @@ int GetItemSelection()
     auto ItemSelectionText = []() { printf("Select an item to update. "); };
 
     auto ItemValidation = [](int ItemID) {
-        sqlite3_stmt* Item = GetItem(ItemID);
-        sqlite3_finalize(Item);
-        return Item != nullptr;
+        return FindCatalogItem(ItemID) != nullptr;
     };
 
-    sqlite3_stmt* ItemList = GetItemList();
+    keyset_pager ItemPager = GetItemPager();
     int ItemID =
-        GetPagingSelection(ItemList, GetItemCount(), "item", ItemPrintCallback,
+        GetPagingSelection(ItemPager, GetItemCount(), "item", ItemPrintCallback,
                            ItemSelectionText, ItemValidation);
 
-    sqlite3_finalize(ItemList);
+    ClosePager(ItemPager);
     return ItemID;
 }
 
@@ -605,15 +580,9 @@ int GetIngredientSelection(int ItemID)
     PrintLogs();
 
     auto IngredientPrintCallback = [](row_reader Reader) {
-        Reader.integer();
         int SupplyID = Reader.integer();
-        double Quantity = Reader.decimal();
-
-        sqlite3_stmt* Supply = GetSupplyItem(SupplyID);
-
-        Reader = row_reader(Supply, 1);
         const char* SupplyName = Reader.text();
-        Reader.decimal();
+        double Quantity = Reader.decimal();
         const char* UnitName = Reader.text();
 
         printf("%i. %s - %.2lf %s\n", SupplyID, SupplyName, Quantity, UnitName);
@@ -623,23 +592,23 @@ int GetIngredientSelection(int ItemID)
         printf("Select an ingredient to update. ");
     };
 
-    auto IngredientValidation = [](int SupplyID) {
-        sqlite3_stmt* Supply = GetSupplyItem(SupplyID);
-        sqlite3_finalize(Supply);
-        return Supply != nullptr;
+    auto IngredientValidation = [&](int SupplyID) {
+        return FindCatalogIngredient(ItemID, SupplyID) != nullptr;
     };
 
-    sqlite3_stmt* IngredientList = GetIngredientList(ItemID);
+    keyset_pager IngredientPager = GetIngredientDetailPager(ItemID);
     int SupplyID = GetPagingSelection(
-        IngredientList, GetIngredientCount(ItemID), "item",
+        IngredientPager, GetIngredientCount(ItemID), "item",
         IngredientPrintCallback, IngredientSelectionText, IngredientValidation);
 
-    sqlite3_finalize(IngredientList);
+    ClosePager(IngredientPager);
     return SupplyID;
 }
 
 void ShowUpdateItemMenu()
 {
+    RefreshCatalog();
+
     int ItemCount = GetItemCount();
     if (ItemCount == 0)
     {
@@ -659,8 +628,14 @@ void ShowUpdateItemMenu()
         return;
     }
 
-    sqlite3_stmt* Supply = GetSupplyItem(ItemID);
-    const char* SupplyName = row_reader(Supply, 1).text();
+    // Copied, removing the ingredient invalidates the catalogue
+    const catalog_supply* Supply = FindCatalogSupply(SupplyID);
+    if (Supply == nullptr)
+    {
+        BB_LOG_ERROR("No supply with SupplyID = %i", SupplyID);
+        return;
+    }
+    std::string SupplyName = Supply->Name;
 
     while (true)
     {
@@ -691,8 +666,8 @@ void ShowUpdateItemMenu()
                 }
                 else if (DeleteIngredient(ItemID, SupplyID))
                 {
-                    BB_LOG_INFO("'%s' removed from item #%i", SupplyName,
-                                ItemID);
+                    BB_LOG_INFO("'%s' removed from item #%i",
+                                SupplyName.c_str(), ItemID);
                 }
                 return;
             case 2:
@@ -716,7 +691,7 @@ void ShowUpdateItemMenu()
                 if (UpdateIngredient(ItemID, SupplyID, Quantity))
                 {
                     BB_LOG_INFO("Ingredient %s updated with quantity %i",
-                                SupplyName, Quantity);
+                                SupplyName.c_str(), Quantity);
                 }
                 return;
             default:
@@ -724,12 +699,12 @@ void ShowUpdateItemMenu()
                 continue;
         }
     }
-
-    sqlite3_finalize(Supply);
 }
 
 void ShowUpdateOrderMenu()
 {
+    RefreshCatalog();
+
     int OrderCount = GetOrderCount();
     if (OrderCount == 0)
     {
@@ -749,8 +724,14 @@ void ShowUpdateOrderMenu()
         return;
     }
 
-    sqlite3_stmt* Item = GetItem(ItemID);
-    const char* ItemName = row_reader(Item, 1).text();
+    // The line outlives its item when the item is deleted
+    const catalog_item* Item = FindCatalogItem(ItemID);
+    if (Item == nullptr)
+    {
+        BB_LOG_ERROR("No item with ItemID = %i", ItemID);
+        return;
+    }
+    std::string ItemName = Item->Name;
 
     while (true)
     {
@@ -781,7 +762,7 @@ void ShowUpdateOrderMenu()
                 }
                 else if (DeleteOrderItem(OrderNumber, ItemID))
                 {
-                    BB_LOG_INFO("%s removed from order #%i", ItemName,
+                    BB_LOG_INFO("%s removed from order #%i", ItemName.c_str(),
                                 OrderNumber);
                 }
                 return;
@@ -805,8 +786,8 @@ void ShowUpdateOrderMenu()
 
                 if (UpdateOrderItem(OrderNumber, ItemID, Quantity))
                 {
-                    BB_LOG_INFO("Item %s updated with quantity %i", ItemName,
-                                Quantity);
+                    BB_LOG_INFO("Item %s updated with quantity %i",
+                                ItemName.c_str(), Quantity);
                 }
                 return;
             default:
@@ -814,8 +795,6 @@ void ShowUpdateOrderMenu()
                 continue;
         }
     }
-
-    sqlite3_finalize(Item);
 }
 
 void ShowUpdateMenu(bool& ShouldExit)
@@ -872,18 +851,22 @@ void ShowDeleteMenu(bool& ShouldExit)
             case 1:
             {
                 int OrderNumber = GetOrderSelection();
-                if (DeleteOrder(OrderNumber))
+                delete_counts Deleted;
+                if (DeleteOrder(OrderNumber, &Deleted) && Deleted.Orders > 0)
                 {
-                    BB_LOG_INFO("Deleted order #%i", OrderNumber);
+                    BB_LOG_INFO("Deleted order #%i (%" PRId64 " lines)",
+                                OrderNumber, Deleted.OrderItems);
                 }
                 return;
             }
             case 2:
             {
                 int ItemID = GetItemSelection();
-                if (DeleteItem(ItemID))
+                delete_counts Deleted;
+                if (DeleteItem(ItemID, &Deleted) && Deleted.Items > 0)
                 {
-                    BB_LOG_INFO("Deleted item #%i", ItemID);
+                    BB_LOG_INFO("Deleted item #%i (%" PRId64 " ingredients)",
+                                ItemID, Deleted.Ingredients);
                 }
                 return;
             }
@@ -896,15 +879,507 @@ void ShowDeleteMenu(bool& ShouldExit)
     }
 }
 
+// Turns "the last Days days" into an inclusive From date in the same UTC
+// calendar SQLite's current_date stamps orders with. 0 means all history.
+static const char* GetReportStart(int Days, char (&Buffer)[16])
+{
+    if (Days <= 0)
+    {
+        return nullptr;
+    }
+
+    time_t Start = time(nullptr) - (time_t)(Days - 1) * 24 * 60 * 60;
+    strftime(Buffer, sizeof(Buffer), "%Y-%m-%d", gmtime(&Start));
+    return Buffer;
+}
+
+void ShowReportsMenu(bool& ShouldExit)
+{
+    int Report = 0;
+    int Days = 0;
+    while (true)
+    {
+        ClearScreen();
+        PrintLogs();
+
+        char FromBuffer[16];
+        const char* From = GetReportStart(Days, FromBuffer);
+        switch (Report)
+        {
+            case 1: PrintRevenueReport(From, nullptr); break;
+            case 2: PrintTopItemsReport(From, nullptr, 10); break;
+            case 3: PrintOrderSizeReport(From, nullptr); break;
+        }
+
+        printf("Which report would you like to see? (-1 to exit, 0 to go "
+               "back)\n");
+        printf("1. Revenue per day\n");
+        printf("2. Top items\n");
+        printf("3. Items per order\n");
+        printf(">> ");
+
+        int Choice;
+        if (!ReadInt(Choice))
+        {
+            continue;
+        }
+
+        switch (Choice)
+        {
+            case 1:
+            case 2:
+            case 3: break;
+            case 0: return;
+            case -1: ShouldExit = true; return;
+            default:
+                BB_LOG_ERROR("Invalid choice. Choice not available.");
+                continue;
+        }
+
+        while (true)
+        {
+            ClearScreen();
+            PrintLogs();
+
+            printf("How many days back should the report cover? (0 for all "
+                   "sales)\n");
+            printf(">> ");
+
+            if (ReadInt(Days) && Days >= 0)
+            {
+                break;
+            }
+
+            BB_LOG_ERROR("Invalid day count. Expected 0 or more.");
+        }
+
+        ClearLogs();
+        Report = Choice;
+    }
+}
+
+// Not listed in the main menu, reached by entering 9. Queries are only
+// counted from the first visit on, unless started with --query-stats.
+void ShowQueryStatsMenu(bool& ShouldExit)
+{
+    EnableQueryStats();
+    while (true)
+    {
+        ClearScreen();
+        PrintLogs();
+        PrintQueryStats(stdout);
+
+        printf("\n(-1 to exit, 0 to go back, 1 to refresh, 2 to reset)\n");
+        printf(">> ");
+
+        int Choice;
+        if (!ReadInt(Choice))
+        {
+            continue;
+        }
+
+        switch (Choice)
+        {
+            case 1: break;
+            case 2: ResetQueryStats(); break;
+            case 0: return;
+            case -1: ShouldExit = true; return;
+            default:
+                BB_LOG_ERROR("Invalid choice. Choice not available.");
+                continue;
+        }
+    }
+}
+
+struct program_options
+{
+    connection_profile Profile;
+    const char* LogFile;
+    const char* ImportFile;
+    int ImportBatchSize;
+    const char* ScriptFile;
+    std::vector<std::string> Command;
+    const char* ArchiveFile;
+    const char* ArchiveBefore;
+    int ArchiveBatchSize;
+    bool Vacuum;
+    const char* VacuumInto;
+    bool QueryStats;
+    const char* ServeSocket;
+    order_writer_options GroupCommit;
+    const char* ConnectSocket;
+};
+
+static void PrintUsage(const char* Program)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [command...]\n"
+            "  --profile <register|reporting>  Connection profile "
+            "(default: register)\n"
+            "  --journal-mode <mode>           Override PRAGMA journal_mode\n"
+            "  --synchronous <level>           Override PRAGMA synchronous\n"
+            "  --cache-size <pages|-KiB>       Override PRAGMA cache_size\n"
+            "  --mmap-size <bytes>             Override PRAGMA mmap_size\n"
+            "  --temp-store <mode>             Override PRAGMA temp_store\n"
+            "  --busy-timeout <ms>             Override the busy timeout\n"
+            "  --log-file <path>               Also write logs to a rotating "
+            "file\n"
+            "  --import <file|->               Bulk import orders from a CSV "
+            "file or stdin and exit\n"
+            "  --import-batch <orders>         Orders per import transaction "
+            "(default: 5000)\n"
+            "  --exec <file|->                 Run a command script from a "
+            "file or stdin and exit\n"
+            "  --archive <file>                Move old orders into an archive "
+            "database and exit\n"
+            "  --archive-before <YYYY-MM-DD>   Archive orders dated before "
+            "this day\n"
+            "  --archive-batch <orders>        Orders per archive transaction "
+            "(default: 1000)\n"
+            "  --vacuum                        Compact the database and exit\n"
+            "  --vacuum-into <file>            Write a compacted copy to a new "
+            "file and exit\n"
+            "  --query-stats                   Print per-query latency to "
+            "stderr on exit\n"
+            "  --serve <socket>                Run the order service that "
+            "owns all writes\n"
+            "  --group-window <us>             Wait this long for more orders "
+            "to commit together (default: 1000)\n"
+            "  --group-size <orders>           Commit as soon as this many "
+            "orders are waiting (default: 64)\n"
+            "  --connect <socket>              Send writes to the order "
+            "service on this socket\n"
+            "\n"
+            "A command after the options, eg. 'order add 3x2 5x1', is run "
+            "and the program exits.\n"
+            "See commands.hpp for the list of commands.\n",
+            Program);
+}
+
+static bool ParseArguments(int Argc, char** Argv, program_options& Options)
+{
+    for (int i = 1; i < Argc; i++)
+    {
+        const char* Option = Argv[i];
+        if (strncmp(Option, "--", 2) != 0)
+        {
+            // Everything from the first non-option is a single command
+            Options.Command.assign(Argv + i, Argv + Argc);
+            break;
+        }
+
+        if (strcmp(Option, "--vacuum") == 0)
+        {
+            Options.Vacuum = true;
+            continue;
+        }
+
+        if (strcmp(Option, "--query-stats") == 0)
+        {
+            Options.QueryStats = true;
+            continue;
+        }
+
+        if (i + 1 >= Argc)
+        {
+            fprintf(stderr, "Missing value for '%s'.\n", Option);
+            return false;
+        }
+
+        const char* Value = Argv[++i];
+        if (strcmp(Option, "--profile") == 0)
+        {
+            const connection_profile* Found = FindConnectionProfile(Value);
+            if (Found == nullptr)
+            {
+                fprintf(stderr, "Unknown connection profile '%s'.\n", Value);
+                return false;
+            }
+            Options.Profile = *Found;
+        }
+        else if (strcmp(Option, "--journal-mode") == 0)
+        {
+            Options.Profile.JournalMode = Value;
+        }
+        else if (strcmp(Option, "--synchronous") == 0)
+        {
+            Options.Profile.Synchronous = Value;
+        }
+        else if (strcmp(Option, "--cache-size") == 0)
+        {
+            Options.Profile.CacheSize = atoi(Value);
+        }
+        else if (strcmp(Option, "--mmap-size") == 0)
+        {
+            Options.Profile.MmapSize = atoll(Value);
+        }
+        else if (strcmp(Option, "--temp-store") == 0)
+        {
+            Options.Profile.TempStore = Value;
+        }
+        else if (strcmp(Option, "--busy-timeout") == 0)
+        {
+            Options.Profile.BusyTimeout = atoi(Value);
+        }
+        else if (strcmp(Option, "--log-file") == 0)
+        {
+            Options.LogFile = Value;
+        }
+        else if (strcmp(Option, "--import") == 0)
+        {
+            Options.ImportFile = Value;
+        }
+        else if (strcmp(Option, "--exec") == 0)
+        {
+            Options.ScriptFile = Value;
+        }
+        else if (strcmp(Option, "--archive") == 0)
+        {
+            Options.ArchiveFile = Value;
+        }
+        else if (strcmp(Option, "--archive-before") == 0)
+        {
+            Options.ArchiveBefore = Value;
+        }
+        else if (strcmp(Option, "--archive-batch") == 0)
+        {
+            Options.ArchiveBatchSize = atoi(Value);
+            if (Options.ArchiveBatchSize <= 0)
+            {
+                fprintf(stderr,
+                        "--archive-batch must be a positive integer.\n");
+                return false;
+            }
+        }
+        else if (strcmp(Option, "--vacuum-into") == 0)
+        {
+            Options.VacuumInto = Value;
+        }
+        else if (strcmp(Option, "--serve") == 0)
+        {
+            Options.ServeSocket = Value;
+        }
+        else if (strcmp(Option, "--group-window") == 0)
+        {
+            Options.GroupCommit.WindowMicroseconds = atoi(Value);
+            if (Options.GroupCommit.WindowMicroseconds < 0)
+            {
+                fprintf(stderr, "--group-window can't be negative.\n");
+                return false;
+            }
+        }
+        else if (strcmp(Option, "--group-size") == 0)
+        {
+            Options.GroupCommit.MaxBatch = atoi(Value);
+            if (Options.GroupCommit.MaxBatch <= 0)
+            {
+                fprintf(stderr, "--group-size must be a positive integer.\n");
+                return false;
+            }
+        }
+        else if (strcmp(Option, "--connect") == 0)
+        {
+            Options.ConnectSocket = Value;
+        }
+        else if (strcmp(Option, "--import-batch") == 0)
+        {
+            Options.ImportBatchSize = atoi(Value);
+            if (Options.ImportBatchSize <= 0)
+            {
+                fprintf(stderr, "--import-batch must be a positive integer.\n");
+                return false;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option '%s'.\n", Option);
+            return false;
+        }
+    }
+
+    if ((Options.ArchiveFile == nullptr) != (Options.ArchiveBefore == nullptr))
+    {
+        fprintf(stderr, "--archive and --archive-before go together.\n");
+        return false;
+    }
+
+    // Maintenance works on the database file itself, not through the service
+    bool Maintenance = Options.ImportFile != nullptr ||
+                       Options.ArchiveFile != nullptr || Options.Vacuum ||
+                       Options.VacuumInto != nullptr;
+    if (Options.ServeSocket != nullptr &&
+        (Options.ConnectSocket != nullptr || Maintenance))
+    {
+        fprintf(stderr, "--serve can't be combined with --connect, --import, "
+                        "--archive or --vacuum.\n");
+        return false;
+    }
+
+    if (Options.ConnectSocket != nullptr && Maintenance)
+    {
+        fprintf(stderr, "--import, --archive and --vacuum run without "
+                        "--connect.\n");
+        return false;
+    }
+
+    return true;
+}
+
+static void Shutdown(const program_options& Options)
+{
+    if (Options.QueryStats)
+    {
+        PrintQueryStats(stderr);
+    }
+
+    DisconnectOrderService();
+    DatabaseClose();
+    FreeLogger();
+}
+
 int main(int Argc, char** Argv)
 {
+    program_options Options = {};
+    Options.Profile = RegisterProfile;
+    Options.ImportBatchSize = 5000;
+    Options.ArchiveBatchSize = 1000;
+    Options.GroupCommit.WindowMicroseconds = 1000;
+    Options.GroupCommit.MaxBatch = 64;
+    if (!ParseArguments(Argc, Argv, Options))
+    {
+        PrintUsage(Argv[0]);
+        return -1;
+    }
+
+    if (Options.QueryStats)
+    {
+        EnableQueryStats();
+    }
+
     const char DatabaseFile[] = "books_and_brews.db";
-    if (!DatabaseInit(DatabaseFile))
+    if (!DatabaseInit(DatabaseFile, Options.Profile))
     {
         return -1;
     }
 
     LoggerInit(CreateLogger("B&B Logs", 5));
+    if (Options.LogFile != nullptr && !LogFileInit(Options.LogFile))
+    {
+        Shutdown(Options);
+        return -1;
+    }
+
+    if (Options.ServeSocket != nullptr)
+    {
+        bool Result = RunOrderService(Options.ServeSocket, Options.GroupCommit);
+        if (!Result)
+        {
+            PrintLogs();
+        }
+
+        Shutdown(Options);
+        return Result ? 0 : -1;
+    }
+
+    if (Options.ConnectSocket != nullptr &&
+        !ConnectOrderService(Options.ConnectSocket))
+    {
+        PrintLogs();
+        Shutdown(Options);
+        return -1;
+    }
+
+    if (Options.ImportFile != nullptr)
+    {
+        bool UseStdin = strcmp(Options.ImportFile, "-") == 0;
+        FILE* Stream = UseStdin ? stdin : fopen(Options.ImportFile, "r");
+
+        bool Result = false;
+        if (Stream == nullptr)
+        {
+            fprintf(stderr, "Failed to open '%s' for import.\n",
+                    Options.ImportFile);
+        }
+        else
+        {
+            Result = ImportOrders(Stream, Options.ImportBatchSize);
+            if (!UseStdin)
+            {
+                fclose(Stream);
+            }
+        }
+
+        if (!Result)
+        {
+            PrintLogs();
+        }
+
+        Shutdown(Options);
+        return Result ? 0 : -1;
+    }
+
+    if (Options.ArchiveFile != nullptr || Options.Vacuum ||
+        Options.VacuumInto != nullptr)
+    {
+        bool Result = true;
+        if (Options.ArchiveFile != nullptr)
+        {
+            Result = ArchiveOrders(Options.ArchiveFile, Options.ArchiveBefore,
+                                   Options.ArchiveBatchSize);
+        }
+
+        if (Result && Options.Vacuum)
+        {
+            Result = CompactDatabase(nullptr);
+        }
+
+        if (Result && Options.VacuumInto != nullptr)
+        {
+            Result = CompactDatabase(Options.VacuumInto);
+        }
+
+        if (!Result)
+        {
+            PrintLogs();
+        }
+
+        Shutdown(Options);
+        return Result ? 0 : -1;
+    }
+
+    LoadCatalog();
+
+    if (Options.ScriptFile != nullptr || !Options.Command.empty())
+    {
+        bool Result = false;
+        if (Options.ScriptFile == nullptr)
+        {
+            Result = ExecuteCommands(Options.Command);
+        }
+        else
+        {
+            bool UseStdin = strcmp(Options.ScriptFile, "-") == 0;
+            FILE* Stream = UseStdin ? stdin : fopen(Options.ScriptFile, "r");
+            if (Stream == nullptr)
+            {
+                fprintf(stderr, "Failed to open script '%s'.\n",
+                        Options.ScriptFile);
+            }
+            else
+            {
+                Result = ExecuteScript(Stream);
+                if (!UseStdin)
+                {
+                    fclose(Stream);
+                }
+            }
+        }
+
+        Shutdown(Options);
+        return Result ? 0 : -1;
+    }
+
+    TerminalInit();
 
     bool ShouldExit = false;
     while (!ShouldExit)
@@ -916,6 +1391,7 @@ int main(int Argc, char** Argv)
         printf("1. Add\n");
         printf("2. Update\n");
         printf("3. Delete\n");
+        printf("4. Reports\n");
         printf(">> ");
 
         int Choice;
@@ -930,6 +1406,8 @@ int main(int Argc, char** Argv)
             case 1: ShowAddMenu(ShouldExit); break;
             case 2: ShowUpdateMenu(ShouldExit); break;
             case 3: ShowDeleteMenu(ShouldExit); break;
+            case 4: ShowReportsMenu(ShouldExit); break;
+            case 9: ShowQueryStatsMenu(ShouldExit); break;
             case -1: goto cleanup; break;
             default:
                 BB_LOG_ERROR("Invalid choice. Choice not available.");
@@ -939,6 +1417,17 @@ int main(int Argc, char** Argv)
 
 cleanup:
     printf("Exiting...\n");
-    FreeLogger();
+
+#ifdef BB_DEBUG_BUILD
+    statement_cache_stats CacheStats = GetStatementCacheStats();
+    uint64_t Lookups = CacheStats.Hits + CacheStats.Misses;
+    printf("Statement cache: %lu hits, %lu misses (%.1f%% hit rate), %lu "
+           "cached\n",
+           (unsigned long)CacheStats.Hits, (unsigned long)CacheStats.Misses,
+           Lookups ? 100.0 * CacheStats.Hits / Lookups : 0.0,
+           (unsigned long)CacheStats.Cached);
+#endif
+
+    Shutdown(Options);
     return 0;
 }
@@ -0,0 +1,190 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: catalog.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Keep the menu, recipes and supply catalogue in memory.
+ */
+
+#include "catalog.hpp"
+#include "logger.hpp"
+
+static catalog S_Catalog;
+// CatalogVersion when S_Catalog was loaded
+static int S_CatalogVersion;
+
+static int _CatalogVersion()
+{
+    statement Statement =
+        AcquireStatement("SELECT Version FROM CatalogVersion");
+    if (Statement == nullptr || !StepRow(Statement))
+    {
+        return -1;
+    }
+
+    return row_reader(Statement).integer();
+}
+
+bool LoadCatalog()
+{
+    catalog Catalog = {};
+    int Version = _CatalogVersion();
+
+    statement Statement = AcquireStatement(
+        "SELECT ItemID, ItemName, ItemDescription, ItemPrice FROM Item");
+    while (Statement != nullptr && StepRow(Statement))
+    {
+        row_reader Reader(Statement);
+        int ItemID = Reader.integer();
+        if (ItemID < 0)
+        {
+            continue;
+        }
+
+        if (ItemID >= (int)Catalog.Items.size())
+        {
+            Catalog.Items.resize(ItemID + 1);
+        }
+
+        catalog_item& Item = Catalog.Items[ItemID];
+        const char* Name = Reader.text();
+        const char* Description = Reader.text();
+
+        Item.Exists = true;
+        Item.Name = Name ? Name : "";
+        Item.Description = Description ? Description : "";
+        Item.Price = Reader.decimal();
+    }
+    bool Result = Statement != nullptr;
+
+    Statement = AcquireStatement(
+        "SELECT ItemID, SupplyID, Quantity FROM Ingredient"
+        " ORDER BY ItemID, SupplyID");
+    while (Statement != nullptr && StepRow(Statement))
+    {
+        row_reader Reader(Statement);
+        int ItemID = Reader.integer();
+        int SupplyID = Reader.integer();
+        double Quantity = Reader.decimal();
+
+        if (ItemID < 0 || ItemID >= (int)Catalog.Items.size())
+        {
+            continue; // Recipe for an item that no longer exists
+        }
+
+        catalog_item& Item = Catalog.Items[ItemID];
+        if (Item.IngredientCount == 0)
+        {
+            Item.FirstIngredient = Catalog.Ingredients.size();
+        }
+        Item.IngredientCount++;
+
+        Catalog.Ingredients.push_back(
+            {.SupplyID = SupplyID, .Quantity = Quantity});
+    }
+    Result = Result && Statement != nullptr;
+
+    Statement = AcquireStatement(
+        "SELECT SupplyID, SupplyName, UnitName FROM SupplyItem");
+    while (Statement != nullptr && StepRow(Statement))
+    {
+        row_reader Reader(Statement);
+        int SupplyID = Reader.integer();
+        if (SupplyID < 0)
+        {
+            continue;
+        }
+
+        if (SupplyID >= (int)Catalog.Supplies.size())
+        {
+            Catalog.Supplies.resize(SupplyID + 1);
+        }
+
+        catalog_supply& Supply = Catalog.Supplies[SupplyID];
+        Supply.Exists = true;
+        Supply.Name = Reader.text();
+        Supply.UnitName = Reader.text();
+    }
+    Result = Result && Statement != nullptr;
+
+    if (!Result)
+    {
+        BB_LOG_ERROR("Failed to load the menu catalogue.");
+        return false;
+    }
+
+    Catalog.Loaded = true;
+    S_Catalog = std::move(Catalog);
+    S_CatalogVersion = Version;
+    return true;
+}
+
+void InvalidateCatalog()
+{
+    S_Catalog.Loaded = false;
+}
+
+void RefreshCatalog()
+{
+    if (S_Catalog.Loaded && _CatalogVersion() != S_CatalogVersion)
+    {
+        S_Catalog.Loaded = false;
+    }
+}
+
+const catalog_item* FindCatalogItem(int ItemID)
+{
+    if (!S_Catalog.Loaded && !LoadCatalog())
+    {
+        return nullptr;
+    }
+
+    if (ItemID < 0 || ItemID >= (int)S_Catalog.Items.size() ||
+        !S_Catalog.Items[ItemID].Exists)
+    {
+        return nullptr;
+    }
+
+    return &S_Catalog.Items[ItemID];
+}
+
+const catalog_supply* FindCatalogSupply(int SupplyID)
+{
+    if (!S_Catalog.Loaded && !LoadCatalog())
+    {
+        return nullptr;
+    }
+
+    if (SupplyID < 0 || SupplyID >= (int)S_Catalog.Supplies.size() ||
+        !S_Catalog.Supplies[SupplyID].Exists)
+    {
+        return nullptr;
+    }
+
+    return &S_Catalog.Supplies[SupplyID];
+}
+
+const ingredient* FindCatalogIngredient(int ItemID, int SupplyID)
+{
+    const catalog_item* Item = FindCatalogItem(ItemID);
+    if (Item == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (int i = 0; i < Item->IngredientCount; i++)
+    {
+        const ingredient& Ingredient =
+            S_Catalog.Ingredients[Item->FirstIngredient + i];
+        if (Ingredient.SupplyID == SupplyID)
+        {
+            return &Ingredient;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,65 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: catalog.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Keep the menu, recipes and supply catalogue in memory.
+ */
+
+#pragma once
+
+#include "database.hpp"
+#include <string>
+#include <vector>
+
+struct catalog_item
+{
+    bool Exists;
+    std::string Name;
+    std::string Description;
+    double Price;
+    int FirstIngredient; // Index into catalog::Ingredients
+    int IngredientCount;
+};
+
+struct catalog_supply
+{
+    bool Exists;
+    std::string Name;
+    std::string UnitName;
+};
+
+// Items and supplies are indexed directly by ItemID/SupplyID. Ingredients are
+// sorted by ItemID so every recipe is a contiguous run.
+struct catalog
+{
+    bool Loaded;
+    std::vector<catalog_item> Items;
+    std::vector<catalog_supply> Supplies;
+    std::vector<ingredient> Ingredients;
+};
+
+// Not locked, only for the thread that uses the writer connection. Threads on
+// a reader_lease look rows up with the Get*() queries instead.
+bool LoadCatalog();
+
+// Called by every write to Item, Ingredient or SupplyItem. The catalogue is
+// reloaded on the next lookup, so pointers returned before this stay valid
+// until then.
+void InvalidateCatalog();
+
+// Triggers bump CatalogVersion on every change to an item, ingredient or
+// supply name, whichever connection makes it. One query compares it with the
+// loaded catalogue and invalidates it if another register or the order
+// service has changed the menu. Called once per command or screen, before
+// any lookup, so pointers are never invalidated in the middle of one.
+void RefreshCatalog();
+
+// nullptr if the row does not exist
+const catalog_item* FindCatalogItem(int ItemID);
+const catalog_supply* FindCatalogSupply(int SupplyID);
+const ingredient* FindCatalogIngredient(int ItemID, int SupplyID);
@@ -0,0 +1,712 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: commands.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Drive the database from scripts instead of the menus.
+ */
+
+#include "commands.hpp"
+#include "catalog.hpp"
+#include "database.hpp"
+#include "input.hpp"
+#include "logger.hpp"
+#include "reports.hpp"
+#include "service.hpp"
+#include <algorithm>
+#include <ctype.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef std::vector<std::string> arguments;
+
+static bool ParseInt(const std::string& Text, int& Result)
+{
+    char* End;
+    long Value = strtol(Text.c_str(), &End, 10);
+    if (Text.empty() || *End != '\0' || Value < INT_MIN || Value > INT_MAX)
+    {
+        BB_LOG_ERROR("Expected an integer, got '%s'", Text.c_str());
+        return false;
+    }
+
+    Result = (int)Value;
+    return true;
+}
+
+static bool ParsePositiveDouble(const std::string& Text, double& Result)
+{
+    char* End;
+    double Value = strtod(Text.c_str(), &End);
+    if (Text.empty() || *End != '\0' || !(Value > 0))
+    {
+        BB_LOG_ERROR("Expected a positive decimal, got '%s'", Text.c_str());
+        return false;
+    }
+
+    Result = Value;
+    return true;
+}
+
+// "<ID>x<Quantity>", eg. "3x2"
+static bool ParseQuantityPair(const std::string& Text, int& ID,
+                              double& Quantity)
+{
+    size_t Separator = Text.find('x');
+    if (Separator == std::string::npos ||
+        !ParseInt(Text.substr(0, Separator), ID) ||
+        !ParsePositiveDouble(Text.substr(Separator + 1), Quantity))
+    {
+        BB_LOG_ERROR("Expected <ID>x<Quantity>, got '%s'", Text.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static bool ExpectArguments(const arguments& Arguments, size_t Count,
+                            const char* Usage)
+{
+    if (Arguments.size() != Count)
+    {
+        BB_LOG_ERROR("Usage: %s", Usage);
+        return false;
+    }
+
+    return true;
+}
+
+static bool OrderAdd(const arguments& Arguments)
+{
+    if (Arguments.size() < 3)
+    {
+        BB_LOG_ERROR("Usage: order add <ItemID>x<Quantity>...");
+        return false;
+    }
+
+    std::vector<order_input> Items;
+    for (size_t i = 2; i < Arguments.size(); i++)
+    {
+        int ItemID;
+        double Quantity;
+        if (!ParseQuantityPair(Arguments[i], ItemID, Quantity))
+        {
+            return false;
+        }
+
+        if (Quantity != (int)Quantity)
+        {
+            BB_LOG_ERROR("Order quantities must be whole numbers, got '%s'",
+                         Arguments[i].c_str());
+            return false;
+        }
+
+        if (FindCatalogItem(ItemID) == nullptr)
+        {
+            BB_LOG_ERROR("No item with ItemID = %i", ItemID);
+            return false;
+        }
+
+        Items.push_back({.ItemID = ItemID, .Quantity = (int)Quantity});
+    }
+
+    int64_t OrderNumber;
+    if (!CreateOrder(Items, &OrderNumber))
+    {
+        return false;
+    }
+
+    printf("Created order #%" PRId64 "\n", OrderNumber);
+    return true;
+}
+
+static bool OrderSet(const arguments& Arguments)
+{
+    int OrderNumber, ItemID, Quantity;
+    if (!ExpectArguments(Arguments, 5,
+                         "order set <OrderNumber> <ItemID> <Quantity>") ||
+        !ParseInt(Arguments[2], OrderNumber) ||
+        !ParseInt(Arguments[3], ItemID) || !ParseInt(Arguments[4], Quantity))
+    {
+        return false;
+    }
+
+    if (Quantity <= 0)
+    {
+        BB_LOG_ERROR("Quantity must be a positive integer.");
+        return false;
+    }
+
+    statement OrderItem = GetOrderItem(OrderNumber, ItemID);
+    if (OrderItem == nullptr ||
+        !UpdateOrderItem(OrderNumber, ItemID, Quantity))
+    {
+        return false;
+    }
+
+    printf("Order #%i: item %i set to x%i\n", OrderNumber, ItemID, Quantity);
+    return true;
+}
+
+static bool OrderRemove(const arguments& Arguments)
+{
+    int OrderNumber, ItemID;
+    if (!ExpectArguments(Arguments, 4, "order remove <OrderNumber> <ItemID>") ||
+        !ParseInt(Arguments[2], OrderNumber) ||
+        !ParseInt(Arguments[3], ItemID))
+    {
+        return false;
+    }
+
+    statement OrderItem = GetOrderItem(OrderNumber, ItemID);
+    if (OrderItem == nullptr)
+    {
+        return false;
+    }
+
+    // Same rule as the menu, removing the last line removes the order
+    bool Result = GetOrderSize(OrderNumber) == 1
+                      ? DeleteOrder(OrderNumber)
+                      : DeleteOrderItem(OrderNumber, ItemID);
+    if (Result)
+    {
+        printf("Order #%i: item %i removed\n", OrderNumber, ItemID);
+    }
+    return Result;
+}
+
+// Parses Arguments[First...] into distinct keys
+static bool ParseKeys(const arguments& Arguments, size_t First,
+                      std::vector<int>& Keys)
+{
+    for (size_t i = First; i < Arguments.size(); i++)
+    {
+        int Key;
+        if (!ParseInt(Arguments[i], Key))
+        {
+            return false;
+        }
+
+        if (std::find(Keys.begin(), Keys.end(), Key) == Keys.end())
+        {
+            Keys.push_back(Key);
+        }
+    }
+
+    return true;
+}
+
+static bool OrderDelete(const arguments& Arguments)
+{
+    std::vector<int> OrderNumbers;
+    if (Arguments.size() < 3 || !ParseKeys(Arguments, 2, OrderNumbers))
+    {
+        BB_LOG_ERROR("Usage: order delete <OrderNumber>...");
+        return false;
+    }
+
+    delete_counts Deleted;
+    if (!DeleteOrders(OrderNumbers, &Deleted))
+    {
+        return false;
+    }
+
+    if (Deleted.Orders != (int64_t)OrderNumbers.size())
+    {
+        BB_LOG_ERROR("Only %" PRId64 " of the %zu orders exist.",
+                     Deleted.Orders, OrderNumbers.size());
+        return false;
+    }
+
+    printf("Deleted %" PRId64 " orders (%" PRId64 " lines)\n",
+           Deleted.Orders, Deleted.OrderItems);
+    return true;
+}
+
+static bool OrderDeleteDates(const arguments& Arguments)
+{
+    if (!ExpectArguments(Arguments, 4, "order delete-dates <From> <To>"))
+    {
+        return false;
+    }
+
+    const char* From = Arguments[2] == "all" ? nullptr : Arguments[2].c_str();
+    const char* To = Arguments[3] == "all" ? nullptr : Arguments[3].c_str();
+
+    delete_counts Deleted;
+    if (!DeleteOrdersByDate(From, To, &Deleted))
+    {
+        return false;
+    }
+
+    printf("Deleted %" PRId64 " orders (%" PRId64 " lines)\n",
+           Deleted.Orders, Deleted.OrderItems);
+    return true;
+}
+
+static bool OrderList(const arguments& Arguments)
+{
+    if (!ExpectArguments(Arguments, 2, "order list"))
+    {
+        return false;
+    }
+
+    keyset_pager Pager = GetOrderPreviewPager();
+    SetPageSize(Pager, INT_MAX);
+    bool Result = FetchPage(Pager);
+    while (StepPage(Pager))
+    {
+        row_reader Reader(Pager.Statement);
+        int OrderNumber = Reader.integer();
+        const char* OrderDate = Reader.text();
+        const char* Preview = Reader.text();
+
+        printf("#%i %s | %s\n", OrderNumber, OrderDate, Preview ? Preview : "");
+    }
+
+    ClosePager(Pager);
+    return Result;
+}
+
+static bool ItemAdd(const arguments& Arguments)
+{
+    if (Arguments.size() < 6)
+    {
+        BB_LOG_ERROR("Usage: item add <Name> <Description> <Price> "
+                     "<SupplyID>x<Quantity>...");
+        return false;
+    }
+
+    const std::string& Name = Arguments[2];
+    const std::string& Description = Arguments[3];
+    double Price;
+
+    if (!MatchPattern(Name, NamePattern) || Name == "-1")
+    {
+        BB_LOG_ERROR("Invalid item name. Only letters are allowed in the "
+                     "name.");
+        return false;
+    }
+
+    if (!MatchPattern(Description, DescriptionPattern) || Description == "-1")
+    {
+        BB_LOG_ERROR("Invalid item description. Only letters and punctuation "
+                     "are allowed in the description.");
+        return false;
+    }
+
+    if (!ParsePositiveDouble(Arguments[4], Price))
+    {
+        return false;
+    }
+
+    std::vector<ingredient> Ingredients;
+    for (size_t i = 5; i < Arguments.size(); i++)
+    {
+        ingredient Ingredient;
+        if (!ParseQuantityPair(Arguments[i], Ingredient.SupplyID,
+                               Ingredient.Quantity))
+        {
+            return false;
+        }
+
+        if (FindCatalogSupply(Ingredient.SupplyID) == nullptr)
+        {
+            BB_LOG_ERROR("No supply with SupplyID = %i", Ingredient.SupplyID);
+            return false;
+        }
+
+        Ingredients.push_back(Ingredient);
+    }
+
+    int64_t ItemID;
+    if (!CreateItem(Name.c_str(), Description.c_str(), Price, Ingredients,
+                    &ItemID))
+    {
+        return false;
+    }
+
+    printf("Created item #%" PRId64 " '%s'\n", ItemID, Name.c_str());
+    return true;
+}
+
+static bool ItemDelete(const arguments& Arguments)
+{
+    std::vector<int> ItemIDs;
+    if (Arguments.size() < 3 || !ParseKeys(Arguments, 2, ItemIDs))
+    {
+        BB_LOG_ERROR("Usage: item delete <ItemID>...");
+        return false;
+    }
+
+    for (int ItemID : ItemIDs)
+    {
+        if (FindCatalogItem(ItemID) == nullptr)
+        {
+            BB_LOG_ERROR("No item with ItemID = %i", ItemID);
+            return false;
+        }
+    }
+
+    delete_counts Deleted;
+    if (!DeleteItems(ItemIDs, &Deleted))
+    {
+        return false;
+    }
+
+    printf("Deleted %" PRId64 " items (%" PRId64 " ingredients)\n",
+           Deleted.Items, Deleted.Ingredients);
+    return true;
+}
+
+static bool ItemList(const arguments& Arguments)
+{
+    if (!ExpectArguments(Arguments, 2, "item list"))
+    {
+        return false;
+    }
+
+    reader_lease Lease;
+    statement Items = GetItemList();
+    while (Items != nullptr && StepRow(Items))
+    {
+        row_reader Reader(Items);
+        int ItemID = Reader.integer();
+        const char* ItemName = Reader.text();
+        Reader.text();
+        double ItemPrice = Reader.decimal();
+
+        printf("%i. %s - $%.2lf\n", ItemID, ItemName, ItemPrice);
+    }
+
+    return Items != nullptr;
+}
+
+static bool IngredientSet(const arguments& Arguments)
+{
+    int ItemID, SupplyID;
+    double Quantity;
+    if (!ExpectArguments(Arguments, 5,
+                         "ingredient set <ItemID> <SupplyID> <Quantity>") ||
+        !ParseInt(Arguments[2], ItemID) || !ParseInt(Arguments[3], SupplyID) ||
+        !ParsePositiveDouble(Arguments[4], Quantity))
+    {
+        return false;
+    }
+
+    if (FindCatalogIngredient(ItemID, SupplyID) == nullptr)
+    {
+        BB_LOG_ERROR("Item #%i has no ingredient with SupplyID = %i", ItemID,
+                     SupplyID);
+        return false;
+    }
+
+    if (!UpdateIngredient(ItemID, SupplyID, Quantity))
+    {
+        return false;
+    }
+
+    printf("Item #%i: supply %i set to %.2lf\n", ItemID, SupplyID, Quantity);
+    return true;
+}
+
+static bool IngredientRemove(const arguments& Arguments)
+{
+    int ItemID, SupplyID;
+    if (!ExpectArguments(Arguments, 4,
+                         "ingredient remove <ItemID> <SupplyID>") ||
+        !ParseInt(Arguments[2], ItemID) || !ParseInt(Arguments[3], SupplyID))
+    {
+        return false;
+    }
+
+    if (FindCatalogIngredient(ItemID, SupplyID) == nullptr)
+    {
+        BB_LOG_ERROR("Item #%i has no ingredient with SupplyID = %i", ItemID,
+                     SupplyID);
+        return false;
+    }
+
+    // Same rule as the menu, removing the last ingredient removes the item
+    bool Result = GetIngredientCount(ItemID) == 1
+                      ? DeleteItem(ItemID)
+                      : DeleteIngredient(ItemID, SupplyID);
+    if (Result)
+    {
+        printf("Item #%i: supply %i removed\n", ItemID, SupplyID);
+    }
+    return Result;
+}
+
+static bool SupplyAdd(const arguments& Arguments)
+{
+    int Quantity;
+    if (!ExpectArguments(Arguments, 5,
+                         "supply add <Name> <Unit> <Quantity>") ||
+        !ParseInt(Arguments[4], Quantity))
+    {
+        return false;
+    }
+
+    const std::string& Name = Arguments[2];
+    const std::string& Unit = Arguments[3];
+    if (!MatchPattern(Name, NamePattern) || Name == "-1" ||
+        !MatchPattern(Unit, UnitPattern) || Unit == "-1")
+    {
+        BB_LOG_ERROR("Invalid supply or unit name. Only letters are allowed "
+                     "in the name.");
+        return false;
+    }
+
+    if (Quantity < 0)
+    {
+        BB_LOG_ERROR("Current stock quantity must be >= 0.");
+        return false;
+    }
+
+    int64_t SupplyID;
+    if (!CreateSupply(Name.c_str(), Unit.c_str(), Quantity, &SupplyID))
+    {
+        return false;
+    }
+
+    printf("Created supply #%" PRId64 " '%s'\n", SupplyID, Name.c_str());
+    return true;
+}
+
+static bool SupplyList(const arguments& Arguments)
+{
+    if (!ExpectArguments(Arguments, 2, "supply list"))
+    {
+        return false;
+    }
+
+    reader_lease Lease;
+    statement Supplies = GetSupplyList();
+    while (Supplies != nullptr && StepRow(Supplies))
+    {
+        row_reader Reader(Supplies);
+        int SupplyID = Reader.integer();
+        const char* SupplyName = Reader.text();
+        double StockQuantity = Reader.decimal();
+        const char* UnitName = Reader.text();
+
+        printf("%i. %s - %.2lf %s\n", SupplyID, SupplyName, StockQuantity,
+               UnitName);
+    }
+
+    return Supplies != nullptr;
+}
+
+// Optional From/To dates after the verb, "all" or a missing one leaves that
+// end of the range open
+static const char* ReportDate(const arguments& Arguments, size_t Index)
+{
+    if (Index >= Arguments.size() || Arguments[Index] == "all")
+    {
+        return nullptr;
+    }
+    return Arguments[Index].c_str();
+}
+
+static bool ReportRevenue(const arguments& Arguments)
+{
+    if (Arguments.size() > 4)
+    {
+        BB_LOG_ERROR("Usage: report revenue [From] [To]");
+        return false;
+    }
+
+    return PrintRevenueReport(ReportDate(Arguments, 2),
+                              ReportDate(Arguments, 3));
+}
+
+static bool ReportTop(const arguments& Arguments)
+{
+    int Limit = 10;
+    if (Arguments.size() > 5 ||
+        (Arguments.size() == 5 && !ParseInt(Arguments[4], Limit)))
+    {
+        BB_LOG_ERROR("Usage: report top [From] [To] [Limit]");
+        return false;
+    }
+
+    return PrintTopItemsReport(ReportDate(Arguments, 2),
+                               ReportDate(Arguments, 3), Limit);
+}
+
+static bool ReportSize(const arguments& Arguments)
+{
+    if (Arguments.size() > 4)
+    {
+        BB_LOG_ERROR("Usage: report size [From] [To]");
+        return false;
+    }
+
+    return PrintOrderSizeReport(ReportDate(Arguments, 2),
+                                ReportDate(Arguments, 3));
+}
+
+struct command
+{
+    const char* Noun;
+    const char* Verb;
+    bool (*Execute)(const arguments& Arguments);
+};
+
+static const command Commands[] = {
+    {"order",      "add",          OrderAdd        },
+    {"order",      "set",          OrderSet        },
+    {"order",      "remove",       OrderRemove     },
+    {"order",      "delete",       OrderDelete     },
+    {"order",      "delete-dates", OrderDeleteDates},
+    {"order",      "list",         OrderList       },
+    {"item",       "add",          ItemAdd         },
+    {"item",       "delete",       ItemDelete      },
+    {"item",       "list",         ItemList        },
+    {"ingredient", "set",          IngredientSet   },
+    {"ingredient", "remove",       IngredientRemove},
+    {"supply",     "add",          SupplyAdd       },
+    {"supply",     "list",         SupplyList      },
+    {"report",     "revenue",      ReportRevenue   },
+    {"report",     "top",          ReportTop       },
+    {"report",     "size",         ReportSize      },
+};
+
+static bool ExecuteCommand(const arguments& Arguments)
+{
+    RefreshCatalog();
+
+    if (Arguments.size() >= 2)
+    {
+        for (const command& Command : Commands)
+        {
+            if (Arguments[0] == Command.Noun && Arguments[1] == Command.Verb)
+            {
+                return Command.Execute(Arguments);
+            }
+        }
+    }
+
+    BB_LOG_ERROR("Unknown command '%s%s%s'",
+                 Arguments.empty() ? "" : Arguments[0].c_str(),
+                 Arguments.size() < 2 ? "" : " ",
+                 Arguments.size() < 2 ? "" : Arguments[1].c_str());
+    return false;
+}
+
+// Splits on whitespace, "double quotes" group words and '#' starts a comment
+static arguments Tokenize(const char* Line)
+{
+    arguments Tokens;
+    const char* Character = Line;
+    while (true)
+    {
+        while (isspace((unsigned char)*Character))
+        {
+            Character++;
+        }
+
+        if (*Character == '\0' || *Character == '#')
+        {
+            break;
+        }
+
+        std::string Token;
+        if (*Character == '"')
+        {
+            Character++;
+            while (*Character != '\0' && *Character != '"')
+            {
+                Token += *Character++;
+            }
+            if (*Character == '"')
+            {
+                Character++;
+            }
+        }
+        else
+        {
+            while (*Character != '\0' && !isspace((unsigned char)*Character))
+            {
+                Token += *Character++;
+            }
+        }
+
+        Tokens.push_back(Token);
+    }
+
+    return Tokens;
+}
+
+bool ExecuteCommands(const std::vector<std::string>& Arguments)
+{
+    ClearLogs();
+    Transaction();
+
+    bool Result = ExecuteCommand(Arguments);
+    Result ? Commit() : Rollback();
+
+    if (!Result)
+    {
+        PrintLogs();
+    }
+    return Result;
+}
+
+bool ExecuteScript(FILE* Stream)
+{
+    ClearLogs();
+    Transaction();
+
+    char Line[1024];
+    long LineNumber = 0;
+    long CommandCount = 0;
+    bool Result = true;
+    while (Result && fgets(Line, sizeof(Line), Stream))
+    {
+        LineNumber++;
+        arguments Arguments = Tokenize(Line);
+        if (Arguments.empty())
+        {
+            continue;
+        }
+
+        if ((Result = ExecuteCommand(Arguments)))
+        {
+            CommandCount++;
+        }
+    }
+
+    if (Result)
+    {
+        Commit();
+        printf("Executed %li commands\n", CommandCount);
+    }
+    else
+    {
+        Rollback();
+        fflush(stdout);
+        // The service commits each write as it arrives, nothing is undone
+        if (OrderServiceConnected())
+        {
+            fprintf(stderr,
+                    "Line %li failed, the %li commands before it were kept.\n",
+                    LineNumber, CommandCount);
+        }
+        else
+        {
+            fprintf(stderr, "Line %li failed, rolled back all %li commands.\n",
+                    LineNumber, CommandCount + 1);
+        }
+        PrintLogs();
+    }
+
+    return Result;
+}
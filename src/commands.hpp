@@ -0,0 +1,45 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: commands.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Drive the database from scripts instead of the menus.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+ * Commands, one per line in a script or given directly on the command line:
+ *
+ *     order add <ItemID>x<Quantity>...
+ *     order set <OrderNumber> <ItemID> <Quantity>
+ *     order remove <OrderNumber> <ItemID>
+ *     order delete <OrderNumber>...
+ *     order delete-dates <From> <To>
+ *     order list
+ *     item add "<Name>" "<Description>" <Price> <SupplyID>x<Quantity>...
+ *     item delete <ItemID>...
+ *     item list
+ *     ingredient set <ItemID> <SupplyID> <Quantity>
+ *     ingredient remove <ItemID> <SupplyID>
+ *     supply add "<Name>" <Unit> <Quantity>
+ *     supply list
+ *     report revenue [From] [To]
+ *     report top [From] [To] [Limit]
+ *     report size [From] [To]
+ *
+ * Dates are YYYY-MM-DD, "all" or a missing date leaves that end of the range
+ * open. Text after a '#' is a comment. A batch runs in a single transaction
+ * and the first failing command rolls back the whole batch, unless the
+ * writes go to the order service where each one commits on its own.
+ */
+bool ExecuteCommands(const std::vector<std::string>& Arguments);
+bool ExecuteScript(FILE* Stream);
@@ -11,20 +11,218 @@
  */
 
 #include "database.hpp"
+#include "catalog.hpp"
 #include "logger.hpp"
+#include "migrations.hpp"
+#include "query_stats.hpp"
+#include "service.hpp"
 #include <assert.h>
+#include <condition_variable>
+#include <inttypes.h>
+#include <limits.h>
+#include <mutex>
+#include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
+#include <string>
+#include <strings.h>
 #include <unistd.h>
+#include <unordered_map>
 
-sqlite3* Database;
+struct database_connection
+{
+    sqlite3* Handle;
+    bool Traced; // QueryStatsInit() has been called on Handle
+
+    // Compiled statements keyed by their SQL text, finalized when the
+    // connection closes
+    std::unordered_map<std::string, sqlite3_stmt*> StatementCache;
+    std::unordered_map<sqlite3_stmt*, bool> CachedStatementsInUse;
+    statement_cache_stats StatementCacheStats;
+
+#ifdef BB_DEBUG_BUILD
+    // Statements currently owned by a statement handle, with the SQL each
+    // was compiled from, so closing can name the ones never released
+    std::unordered_map<sqlite3_stmt*, std::string> OpenStatements;
+#endif
+};
+
+static database_connection* S_Writer;
+static bool S_StatementCaching = true;
+
+// Reader pool. Connections are opened lazily and kept until DatabaseClose().
+static std::mutex S_ReaderLock;
+static std::condition_variable S_ReaderReturned;
+static std::vector<database_connection*> S_Readers;
+static std::vector<database_connection*> S_IdleReaders;
+static int S_ReadersOpening;
+static std::string S_DatabaseFile;
+static connection_profile S_Profile;
+
+// Set by a reader_lease, threads without one use S_Writer
+static thread_local database_connection* S_ThreadConnection;
+// Transaction() calls not yet committed or rolled back on this thread
+static thread_local int S_TransactionDepth;
+
+static database_connection* _Connection()
+{
+    database_connection* Connection =
+        S_ThreadConnection != nullptr ? S_ThreadConnection : S_Writer;
+
+    // Hooked from the thread using the connection, never while another has it
+    if (Connection != nullptr && !Connection->Traced && QueryStatsEnabled())
+    {
+        QueryStatsInit(Connection->Handle);
+        Connection->Traced = true;
+    }
+    return Connection;
+}
+
+sqlite3* DatabaseHandle()
+{
+    database_connection* Connection = _Connection();
+    return Connection != nullptr ? Connection->Handle : nullptr;
+}
+
+const connection_profile RegisterProfile = {
+    .Name = "register",
+    .JournalMode = "WAL",
+    .Synchronous = "NORMAL", // WAL stays consistent, only the fsync per
+                             // commit is skipped
+    .CacheSize = -8192,      // 8 MiB
+    .MmapSize = 64ll << 20,
+    .TempStore = "MEMORY",
+    .BusyTimeout = 2000,
+    .ReadConnections = 2,
+};
+
+const connection_profile ReportingProfile = {
+    .Name = "reporting",
+    .JournalMode = "WAL",
+    .Synchronous = "NORMAL",
+    .CacheSize = -65536, // 64 MiB
+    .MmapSize = 512ll << 20,
+    .TempStore = "MEMORY",
+    .BusyTimeout = 10000,
+    .ReadConnections = 4,
+};
+
+const connection_profile* FindConnectionProfile(const char* Name)
+{
+    const connection_profile* Profiles[] = {&RegisterProfile,
+                                            &ReportingProfile};
+    for (const connection_profile* Profile : Profiles)
+    {
+        if (strcmp(Profile->Name, Name) == 0)
+        {
+            return Profile;
+        }
+    }
+
+    return nullptr;
+}
 
-bool DatabaseInit(const char* FileName)
+static bool _ApplyPragma(sqlite3* Handle, const char* Format, ...)
 {
-    if (sqlite3_open_v2(FileName, &Database, SQLITE_OPEN_READWRITE, nullptr) !=
-        SQLITE_OK)
+    char Query[256];
+
+    va_list VArgs;
+    va_start(VArgs, Format);
+    vsnprintf(Query, sizeof(Query), Format, VArgs);
+    va_end(VArgs);
+
+    char* Error = nullptr;
+    if (sqlite3_exec(Handle, Query, nullptr, nullptr, &Error) != SQLITE_OK)
+    {
+        fprintf(stderr, "Failed to apply '%s'. (%s)\n", Query, Error);
+        sqlite3_free(Error);
+        return false;
+    }
+
+    return true;
+}
+
+// Journal mode and synchronous only matter to the writer, and a read-only
+// connection can't change the journal mode anyway
+static database_connection* _OpenConnection(const char* FileName,
+                                            const connection_profile& Profile,
+                                            bool ReadOnly)
+{
+    sqlite3* Handle = nullptr;
+    int Flags = ReadOnly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
+    if (sqlite3_open_v2(FileName, &Handle, Flags, nullptr) != SQLITE_OK)
     {
         fprintf(stderr, "Failed to open database with file '%s'. (%s)\n",
-                FileName, sqlite3_errmsg(Database));
+                FileName, sqlite3_errmsg(Handle));
+        sqlite3_close_v2(Handle);
+        return nullptr;
+    }
+
+    sqlite3_busy_timeout(Handle, Profile.BusyTimeout);
+
+    bool Result =
+        (ReadOnly ||
+         (_ApplyPragma(Handle, "PRAGMA journal_mode = %s;",
+                       Profile.JournalMode) &&
+          _ApplyPragma(Handle, "PRAGMA synchronous = %s;",
+                       Profile.Synchronous))) &&
+        _ApplyPragma(Handle, "PRAGMA cache_size = %i;", Profile.CacheSize) &&
+        _ApplyPragma(Handle, "PRAGMA mmap_size = %lld;",
+                     (long long)Profile.MmapSize) &&
+        _ApplyPragma(Handle, "PRAGMA temp_store = %s;", Profile.TempStore);
+
+    if (!Result)
+    {
+        fprintf(stderr, "Failed to apply connection profile '%s'.\n",
+                Profile.Name);
+        sqlite3_close_v2(Handle);
+        return nullptr;
+    }
+
+    database_connection* Connection = new database_connection();
+    Connection->Handle = Handle;
+    return Connection;
+}
+
+static void _CloseConnection(database_connection* Connection)
+{
+#ifdef BB_DEBUG_BUILD
+    for (const auto& Open : Connection->OpenStatements)
+    {
+        fprintf(stderr, "Statement still open at close: '%s'\n",
+                Open.second.c_str());
+        if (Connection->CachedStatementsInUse.count(Open.first) == 0)
+        {
+            sqlite3_finalize(Open.first);
+        }
+    }
+#endif
+
+    for (const auto& Cached : Connection->StatementCache)
+    {
+        sqlite3_finalize(Cached.second);
+    }
+
+    sqlite3_close_v2(Connection->Handle);
+    delete Connection;
+}
+
+bool DatabaseInit(const char* FileName, const connection_profile& Profile)
+{
+    S_Writer = _OpenConnection(FileName, Profile, false);
+    if (S_Writer == nullptr)
+    {
+        return false;
+    }
+
+    S_DatabaseFile = FileName;
+    S_Profile = Profile;
+
+    if (!RunMigrations())
+    {
+        fprintf(stderr, "Failed to bring '%s' up to the current schema.\n",
+                FileName);
+        DatabaseClose();
         return false;
     }
 
@@ -33,7 +231,122 @@ bool DatabaseInit(const char* FileName)
 
 void DatabaseClose()
 {
-    sqlite3_close_v2(Database);
+    std::lock_guard<std::mutex> Guard(S_ReaderLock);
+    assert(S_IdleReaders.size() == S_Readers.size() &&
+           "A reader_lease is still held");
+    for (database_connection* Reader : S_Readers)
+    {
+        _CloseConnection(Reader);
+    }
+    S_Readers.clear();
+    S_IdleReaders.clear();
+
+    if (S_Writer != nullptr)
+    {
+        _CloseConnection(S_Writer);
+        S_Writer = nullptr;
+    }
+}
+
+// Takes a connection from the reader pool, opening a new one while the pool
+// is below the profile's ReadConnections. Without Wait a full pool gives
+// nullptr rather than waiting for a connection to come back. Also nullptr
+// without a pool, or inside the calling thread's own write transaction,
+// whose uncommitted rows only the writer can see.
+static database_connection* _TakeReader(bool Wait)
+{
+    if (S_ThreadConnection == nullptr && S_TransactionDepth > 0)
+    {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> Lock(S_ReaderLock);
+    int Limit = S_Profile.ReadConnections;
+    if (S_Writer == nullptr || Limit <= 0)
+    {
+        return nullptr;
+    }
+
+    auto Available = [Limit] {
+        return !S_IdleReaders.empty() ||
+               (int)S_Readers.size() + S_ReadersOpening < Limit;
+    };
+    if (!Wait && !Available())
+    {
+        return nullptr;
+    }
+    S_ReaderReturned.wait(Lock, Available);
+
+    database_connection* Connection;
+    if (!S_IdleReaders.empty())
+    {
+        Connection = S_IdleReaders.back();
+        S_IdleReaders.pop_back();
+    }
+    else
+    {
+        // Opened outside the lock, other leases can come and go meanwhile
+        S_ReadersOpening++;
+        Lock.unlock();
+        Connection = _OpenConnection(S_DatabaseFile.c_str(), S_Profile, true);
+        Lock.lock();
+        S_ReadersOpening--;
+
+        if (Connection == nullptr)
+        {
+            S_ReaderReturned.notify_one();
+            Lock.unlock();
+            BB_LOG_ERROR("Failed to open a read-only connection.");
+            return nullptr;
+        }
+        S_Readers.push_back(Connection);
+    }
+
+    return Connection;
+}
+
+static void _ReturnReader(database_connection* Connection)
+{
+#ifdef BB_DEBUG_BUILD
+    for (const auto& Open : Connection->OpenStatements)
+    {
+        fprintf(stderr, "Statement still open on a returned reader: '%s'\n",
+                Open.second.c_str());
+    }
+#endif
+
+    // A read transaction left open would pin the snapshot for the next lease
+    if (!sqlite3_get_autocommit(Connection->Handle))
+    {
+        sqlite3_exec(Connection->Handle, "ROLLBACK;", nullptr, nullptr,
+                     nullptr);
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(S_ReaderLock);
+        S_IdleReaders.push_back(Connection);
+    }
+    S_ReaderReturned.notify_one();
+}
+
+reader_lease::reader_lease()
+    : Connection(_TakeReader(true)), Previous(S_ThreadConnection)
+{
+    if (Connection != nullptr)
+    {
+        S_ThreadConnection = Connection;
+    }
+}
+
+reader_lease::~reader_lease()
+{
+    if (Connection == nullptr)
+    {
+        return;
+    }
+
+    S_ThreadConnection = Previous;
+    _ReturnReader(Connection);
 }
 
 row_reader::row_reader(sqlite3_stmt* Statement) : row_reader(Statement, 0) {}
@@ -70,6 +383,12 @@ statement_binder& statement_binder::integer(int Value)
     return *this;
 }
 
+statement_binder& statement_binder::integer64(int64_t Value)
+{
+    sqlite3_bind_int64(Statement, BindIndex++, Value);
+    return *this;
+}
+
 statement_binder& statement_binder::decimal(double Value)
 {
     sqlite3_bind_double(Statement, BindIndex++, Value);
@@ -82,97 +401,647 @@ statement_binder& statement_binder::text(const char* Text)
     return *this;
 }
 
-void Transaction()
-{
-    sqlite3_exec(Database, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr);
+// Savepoints instead of BEGIN/COMMIT so transactions nest. The outermost
+// SAVEPOINT opens a deferred transaction and releasing it commits, while an
+// inner one lets a single operation roll back inside a larger batch. With the
+// order service connected they do nothing, the writes commit in the service
+// and a local read transaction would only hide them.
+void Transaction()
+{
+    if (OrderServiceConnected())
+    {
+        return;
+    }
+
+    sqlite3_exec(DatabaseHandle(), "SAVEPOINT bb;", nullptr, nullptr, nullptr);
+    S_TransactionDepth++;
+}
+
+void Commit()
+{
+    if (OrderServiceConnected())
+    {
+        return;
+    }
+
+    sqlite3_exec(DatabaseHandle(), "RELEASE bb;", nullptr, nullptr, nullptr);
+    if (S_TransactionDepth > 0)
+    {
+        S_TransactionDepth--;
+    }
+}
+
+void Rollback()
+{
+    if (OrderServiceConnected())
+    {
+        return;
+    }
+
+    sqlite3_exec(DatabaseHandle(), "ROLLBACK TO bb; RELEASE bb;", nullptr,
+                 nullptr, nullptr);
+    if (S_TransactionDepth > 0)
+    {
+        S_TransactionDepth--;
+    }
+}
+
+// Only right after the insert, on the connection that made it
+static int64_t _LastInsertRowID()
+{
+    return sqlite3_last_insert_rowid(DatabaseHandle());
+}
+
+static bool _Execute(sqlite3_stmt* Statement)
+{
+    if (sqlite3_step(Statement) != SQLITE_DONE)
+    {
+        BB_LOG_ERROR("Failed to step query. (%s)",
+                     sqlite3_errmsg(DatabaseHandle()));
+        return false;
+    }
+
+    return true;
+}
+
+bool StepRow(sqlite3_stmt* Statement)
+{
+    int StepResult = sqlite3_step(Statement);
+
+    if (StepResult == SQLITE_DONE)
+    {
+        return false; // No more rows, return false
+    }
+
+    if (StepResult != SQLITE_ROW) // Not returning a row, log the error
+    {
+        BB_LOG_ERROR("Failed to step query. (%s)",
+                     sqlite3_errmsg(sqlite3_db_handle(Statement)));
+        return false;
+    }
+
+    return true;
+}
+
+sqlite3_stmt* Prepare(const char* Query)
+{
+    sqlite3_stmt* Statement = nullptr;
+    if (sqlite3_prepare_v2(DatabaseHandle(), Query, -1, &Statement,
+                           nullptr) != SQLITE_OK)
+    {
+        BB_LOG_DEBUG("Failed to prepare query. '%s' (%s)", Query,
+                     sqlite3_errmsg(DatabaseHandle()));
+        Statement = nullptr;
+    }
+    return Statement;
+}
+
+// Gives a statement back to its connection's cache, or finalizes it if it
+// isn't the cached copy. Statements outliving the connections are left alone,
+// DatabaseClose() already reported and finalized them.
+static void _ReleaseStatement(sqlite3_stmt* Statement,
+                              database_connection* Connection)
+{
+    if (Statement == nullptr || S_Writer == nullptr)
+    {
+        return;
+    }
+
+#ifdef BB_DEBUG_BUILD
+    Connection->OpenStatements.erase(Statement);
+#endif
+
+    auto Cached = Connection->CachedStatementsInUse.find(Statement);
+    if (Cached == Connection->CachedStatementsInUse.end())
+    {
+        sqlite3_finalize(Statement);
+        return;
+    }
+
+    sqlite3_reset(Statement);
+    sqlite3_clear_bindings(Statement);
+    Cached->second = false;
+}
+
+statement::statement() : Statement(nullptr), Connection(nullptr) {}
+
+statement::statement(sqlite3_stmt* Statement)
+    : Statement(Statement), Connection(_Connection())
+{
+#ifdef BB_DEBUG_BUILD
+    if (Statement != nullptr)
+    {
+        Connection->OpenStatements[Statement] = sqlite3_sql(Statement);
+    }
+#endif
+}
+
+statement::statement(statement&& Other)
+    : Statement(Other.Statement), Connection(Other.Connection)
+{
+    Other.Statement = nullptr;
+}
+
+statement& statement::operator=(statement&& Other)
+{
+    if (this != &Other)
+    {
+        _ReleaseStatement(Statement, Connection);
+        Statement = Other.Statement;
+        Connection = Other.Connection;
+        Other.Statement = nullptr;
+    }
+    return *this;
+}
+
+statement::~statement()
+{
+    _ReleaseStatement(Statement, Connection);
+}
+
+statement AcquireStatement(const char* Query)
+{
+    database_connection* Connection = _Connection();
+    if (Connection == nullptr)
+    {
+        BB_LOG_ERROR("No database connection for '%s'.", Query);
+        return statement();
+    }
+
+    statement_cache_stats& Stats = Connection->StatementCacheStats;
+    if (!S_StatementCaching)
+    {
+        Stats.Misses++;
+        return statement(Prepare(Query));
+    }
+
+    auto Cached = Connection->StatementCache.find(Query);
+    if (Cached != Connection->StatementCache.end())
+    {
+        bool& InUse = Connection->CachedStatementsInUse[Cached->second];
+        if (!InUse)
+        {
+            InUse = true;
+            Stats.Hits++;
+            return statement(Cached->second);
+        }
+    }
+
+    // Either never seen or the cached copy is still handed out, compile a new
+    // one. Only the first copy of a query is kept, the rest are finalized on
+    // release.
+    Stats.Misses++;
+    sqlite3_stmt* Statement = Prepare(Query);
+    if (Statement != nullptr && Cached == Connection->StatementCache.end())
+    {
+        Connection->StatementCache[Query] = Statement;
+        Connection->CachedStatementsInUse[Statement] = true;
+    }
+
+    return statement(Statement);
+}
+
+void ReleaseStatement(statement& Statement)
+{
+    _ReleaseStatement(Statement.Statement, Statement.Connection);
+    Statement.Statement = nullptr;
+}
+
+void SetStatementCaching(bool Enabled)
+{
+    S_StatementCaching = Enabled;
+}
+
+statement_cache_stats GetStatementCacheStats()
+{
+    database_connection* Connection = _Connection();
+    if (Connection == nullptr)
+    {
+        return {};
+    }
+
+    statement_cache_stats Stats = Connection->StatementCacheStats;
+    Stats.Cached = Connection->StatementCache.size();
+    return Stats;
+}
+
+// Counts come from RowCounts, which triggers on each counted table keep
+// current (migration 3), so this is one primary key lookup instead of a
+// COUNT(*) walk over the whole table.
+static int _GetCount(const char* Table)
+{
+    int Result = 0;
+
+    statement Statement =
+        AcquireStatement("SELECT RowCount FROM RowCounts WHERE TableName = ?");
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement).text(Table);
+        if (StepRow(Statement))
+        {
+            Result = sqlite3_column_int(Statement, 0);
+        }
+        else
+        {
+            BB_LOG_ERROR("No row count is kept for %s", Table);
+        }
+    }
+
+    return Result;
+}
+
+static statement _GetList(const char* Table)
+{
+    char Query[256];
+    snprintf(Query, sizeof(Query), "SELECT * FROM %s", Table);
+    statement Statement = AcquireStatement(Query);
+    return Statement;
+}
+
+static keyset_pager _CreatePager(const char* Query, int KeyColumn)
+{
+    keyset_pager Pager = {};
+
+    // A pager steps part way through its query and waits on the user between
+    // pages. Without WAL the read lock it holds meanwhile would stall writes.
+    if (strcasecmp(S_Profile.JournalMode, "WAL") == 0)
+    {
+        Pager.Reader = _TakeReader(false);
+    }
+
+    database_connection* Previous = S_ThreadConnection;
+    if (Pager.Reader != nullptr)
+    {
+        S_ThreadConnection = Pager.Reader;
+    }
+    Pager.Statement = AcquireStatement(Query);
+    S_ThreadConnection = Previous;
+
+    Pager.KeyColumn = KeyColumn;
+    Pager.PageStarts.push_back(INT_MIN);
+    return Pager;
+}
+
+static keyset_pager _GetPager(const char* Table, const char* Key)
+{
+    char Query[256];
+    snprintf(Query, sizeof(Query),
+             "SELECT * FROM %s WHERE %s > ? ORDER BY %s LIMIT ?", Table, Key,
+             Key);
+    return _CreatePager(Query, 0);
+}
+
+void SetPageSize(keyset_pager& Pager, int RowsPerPage)
+{
+    Pager.RowsPerPage = RowsPerPage;
+    Pager.RowsFetched = 0;
+    Pager.Page = 0;
+    Pager.PageStarts.assign(1, INT_MIN);
+}
+
+bool FetchPage(keyset_pager& Pager)
+{
+    if (Pager.Statement == nullptr)
+    {
+        return false;
+    }
+
+    sqlite3_reset(Pager.Statement);
+
+    // Boundary key and page size are always the last two parameters, anything
+    // before them is a filter bound once when the pager was created.
+    int BoundaryIndex = sqlite3_bind_parameter_count(Pager.Statement) - 1;
+    sqlite3_bind_int(Pager.Statement, BoundaryIndex,
+                     Pager.PageStarts[Pager.Page]);
+    sqlite3_bind_int(Pager.Statement, BoundaryIndex + 1, Pager.RowsPerPage);
+
+    Pager.RowsFetched = 0;
+    return true;
+}
+
+bool StepPage(keyset_pager& Pager)
+{
+    if (Pager.Statement == nullptr || !StepRow(Pager.Statement))
+    {
+        return false;
+    }
+
+    Pager.LastKey = sqlite3_column_int(Pager.Statement, Pager.KeyColumn);
+    Pager.RowsFetched++;
+    return true;
+}
+
+bool NextPage(keyset_pager& Pager)
+{
+    if (Pager.RowsFetched < Pager.RowsPerPage)
+    {
+        return false; // Short page, nothing after it
+    }
+
+    if (Pager.Page + 1 == (int)Pager.PageStarts.size())
+    {
+        Pager.PageStarts.push_back(Pager.LastKey);
+    }
+
+    Pager.Page++;
+    return true;
+}
+
+bool PreviousPage(keyset_pager& Pager)
+{
+    if (Pager.Page == 0)
+    {
+        return false;
+    }
+
+    Pager.Page--;
+    return true;
+}
+
+void ClosePager(keyset_pager& Pager)
+{
+    ReleaseStatement(Pager.Statement);
+    if (Pager.Reader != nullptr)
+    {
+        _ReturnReader(Pager.Reader);
+        Pager.Reader = nullptr;
+    }
+}
+
+// Supply consumed by every line of an order, one row per SupplyID
+#define BB_ORDER_USAGE_QUERY                                                  \
+    "SELECT Ingredient.SupplyID,"                                             \
+    " SUM(Ingredient.Quantity * MenuOrderItem.OrderQuantity) AS Used"         \
+    " FROM MenuOrderItem"                                                     \
+    " JOIN Ingredient ON Ingredient.ItemID = MenuOrderItem.ItemID"            \
+    " WHERE MenuOrderItem.OrderNumber = ?"                                    \
+    " GROUP BY Ingredient.SupplyID"
+
+// Every order line keeps the item's price from when it was recorded, so the
+// revenue taken back out of DailyItemSales is what went in, even after the
+// item is repriced or deleted
+static const char S_InsertOrderItem[] = R"(
+    INSERT INTO MenuOrderItem (OrderNumber, ItemID, OrderQuantity, UnitPrice)
+    VALUES (?1, ?2, ?3, (SELECT ItemPrice FROM Item WHERE ItemID = ?2))
+)";
+
+// Adds Sign times the lines of an order, or only its ItemID line when ItemID
+// is not 0, to the DailyItemSales aggregate, at each line's UnitPrice.
+// Callers add a line after writing it and subtract it before changing or
+// removing it, inside the same transaction.
+static bool _UpdateDailyItemSales(int64_t OrderNumber, int ItemID, int Sign)
+{
+    statement Statement = AcquireStatement(R"(
+        INSERT INTO DailyItemSales
+            (SaleDate, ItemID, Quantity, Revenue, OrderCount)
+        SELECT
+        MenuOrder.OrderDate,
+        MenuOrderItem.ItemID,
+        ?3 * MenuOrderItem.OrderQuantity,
+        ?3 * MenuOrderItem.OrderQuantity *
+            coalesce(MenuOrderItem.UnitPrice, 0),
+        ?3
+        FROM MenuOrderItem
+        JOIN MenuOrder ON MenuOrder.OrderNumber = MenuOrderItem.OrderNumber
+        WHERE MenuOrderItem.OrderNumber = ?1
+            AND (?2 = 0 OR MenuOrderItem.ItemID = ?2)
+        ON CONFLICT(SaleDate, ItemID) DO UPDATE SET
+            Quantity = Quantity + excluded.Quantity,
+            Revenue = Revenue + excluded.Revenue,
+            OrderCount = OrderCount + excluded.OrderCount
+    )");
+
+    bool Result = false;
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement)
+            .integer64(OrderNumber)
+            .integer(ItemID)
+            .integer(Sign);
+        if (!(Result = _Execute(Statement)))
+        {
+            BB_LOG_ERROR(
+                "Failed to update daily sales for OrderNumber = %" PRId64,
+                OrderNumber);
+        }
+    }
+
+    return Result;
+}
+
+// Counts (Sign = 1) or uncounts (Sign = -1) an order in DailyOrders
+static bool _UpdateDailyOrders(int64_t OrderNumber, int Sign)
+{
+    statement Statement = AcquireStatement(R"(
+        INSERT INTO DailyOrders (SaleDate, OrderCount)
+        SELECT OrderDate, ?2
+        FROM MenuOrder
+        WHERE OrderNumber = ?1
+        ON CONFLICT(SaleDate) DO UPDATE SET
+            OrderCount = OrderCount + excluded.OrderCount
+    )");
+
+    bool Result = false;
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement).integer64(OrderNumber).integer(Sign);
+        if (!(Result = _Execute(Statement)))
+        {
+            BB_LOG_ERROR(
+                "Failed to update daily orders for OrderNumber = %" PRId64,
+                OrderNumber);
+        }
+    }
+
+    return Result;
 }
 
-void Commit()
+// Runs a DELETE, binding Key if the query takes a parameter, and adds the
+// number of rows it removed to Deleted.
+static bool _DeleteRows(const char* Query, int Key, int64_t& Deleted)
 {
-    sqlite3_exec(Database, "COMMIT;", nullptr, nullptr, nullptr);
-}
+    statement Statement = AcquireStatement(Query);
 
-void Rollback()
-{
-    sqlite3_exec(Database, "ROLLBACK;", nullptr, nullptr, nullptr);
-}
+    bool Result = false;
+    if (Statement != nullptr)
+    {
+        if (sqlite3_bind_parameter_count(Statement) > 0)
+        {
+            statement_binder(Statement).integer(Key);
+        }
 
-int64_t LastInsertRowID()
-{
-    return sqlite3_last_insert_rowid(Database);
+        if ((Result = _Execute(Statement)))
+        {
+            Deleted += sqlite3_changes(DatabaseHandle());
+        }
+    }
+
+    return Result;
 }
 
-static bool _Execute(sqlite3_stmt* Statement)
+// Batch deletes stage their keys in a temporary table so every table is
+// cleared with one set-based statement, whatever the number of keys.
+static bool _SetDeleteKeys(const std::vector<int>& Keys)
 {
-    if (sqlite3_step(Statement) != SQLITE_DONE)
+    char* Error = nullptr;
+    if (sqlite3_exec(DatabaseHandle(),
+                     "CREATE TEMP TABLE IF NOT EXISTS DeleteKeys"
+                     " (Key INTEGER PRIMARY KEY);"
+                     "DELETE FROM temp.DeleteKeys;",
+                     nullptr, nullptr, &Error) != SQLITE_OK)
     {
-        BB_LOG_ERROR("Failed to step query. (%s)", sqlite3_errmsg(Database));
+        BB_LOG_ERROR("Failed to prepare delete keys. (%s)", Error);
+        sqlite3_free(Error);
         return false;
     }
 
-    return true;
+    statement Statement =
+        AcquireStatement("INSERT OR IGNORE INTO temp.DeleteKeys VALUES (?)");
+
+    bool Result = Statement != nullptr;
+    for (size_t i = 0; Result && i < Keys.size(); i++)
+    {
+        statement_binder(Statement).integer(Keys[i]);
+        Result = _Execute(Statement);
+        sqlite3_reset(Statement);
+    }
+
+    return Result;
 }
 
-bool StepRow(sqlite3_stmt* Statement)
+// Deletes every order in temp.DeleteKeys along with its lines, after taking
+// them out of the daily aggregates.
+static bool _DeleteOrderKeys(delete_counts* Counts)
 {
-    int StepResult = sqlite3_step(Statement);
-
-    if (StepResult == SQLITE_DONE)
+    statement Statement = AcquireStatement(R"(
+        INSERT INTO DailyItemSales
+            (SaleDate, ItemID, Quantity, Revenue, OrderCount)
+        SELECT
+        MenuOrder.OrderDate,
+        MenuOrderItem.ItemID,
+        -sum(MenuOrderItem.OrderQuantity),
+        -sum(MenuOrderItem.OrderQuantity *
+             coalesce(MenuOrderItem.UnitPrice, 0)),
+        -count(*)
+        FROM MenuOrderItem
+        JOIN MenuOrder ON MenuOrder.OrderNumber = MenuOrderItem.OrderNumber
+        WHERE MenuOrderItem.OrderNumber IN (SELECT Key FROM temp.DeleteKeys)
+        GROUP BY MenuOrder.OrderDate, MenuOrderItem.ItemID
+        ON CONFLICT(SaleDate, ItemID) DO UPDATE SET
+            Quantity = Quantity + excluded.Quantity,
+            Revenue = Revenue + excluded.Revenue,
+            OrderCount = OrderCount + excluded.OrderCount
+    )");
+    bool Result = Statement != nullptr && _Execute(Statement);
+
+    Statement = AcquireStatement(R"(
+        INSERT INTO DailyOrders (SaleDate, OrderCount)
+        SELECT OrderDate, -count(*)
+        FROM MenuOrder
+        WHERE OrderNumber IN (SELECT Key FROM temp.DeleteKeys)
+        GROUP BY OrderDate
+        ON CONFLICT(SaleDate) DO UPDATE SET
+            OrderCount = OrderCount + excluded.OrderCount
+    )");
+    Result = Result && Statement != nullptr && _Execute(Statement);
+    ReleaseStatement(Statement);
+
+    delete_counts Deleted = {};
+    Result = Result &&
+             _DeleteRows("DELETE FROM MenuOrderItem WHERE OrderNumber IN"
+                         " (SELECT Key FROM temp.DeleteKeys)",
+                         0, Deleted.OrderItems) &&
+             _DeleteRows("DELETE FROM MenuOrder WHERE OrderNumber IN"
+                         " (SELECT Key FROM temp.DeleteKeys)",
+                         0, Deleted.Orders);
+
+    if (!Result)
     {
-        return false; // No more rows, return false
+        BB_LOG_ERROR("Failed to delete the selected orders.");
     }
-
-    if (StepResult != SQLITE_ROW) // Not returning a row, log the error
+    else if (Counts != nullptr)
     {
-        BB_LOG_ERROR("Failed to step query. (%s)", sqlite3_errmsg(Database));
-        return false;
+        *Counts = Deleted;
     }
-
-    return true;
+    return Result;
 }
 
-sqlite3_stmt* Prepare(const char* Query)
+// Subtracts the supplies used by an order from SupplyItem.StockQuantity with a
+// single aggregated UPDATE. Supplies that would go negative are reported
+// first, and unless AllowNegative is set the order is refused without
+// touching stock. Must run inside the transaction that created the order.
+static bool _DeductStock(int64_t OrderNumber, bool AllowNegative)
 {
-    sqlite3_stmt* Statement = nullptr;
-    if (sqlite3_prepare_v2(Database, Query, -1, &Statement, nullptr) !=
-        SQLITE_OK)
+    statement Statement = AcquireStatement(
+        "SELECT SupplyItem.SupplyName, Usage.Used, SupplyItem.StockQuantity,"
+        " SupplyItem.UnitName"
+        " FROM (" BB_ORDER_USAGE_QUERY ") AS Usage"
+        " JOIN SupplyItem ON SupplyItem.SupplyID = Usage.SupplyID"
+        " WHERE SupplyItem.StockQuantity < Usage.Used");
+
+    if (Statement == nullptr)
     {
-        BB_LOG_DEBUG("Failed to prepare query. '%s' (%s)", Query,
-                     sqlite3_errmsg(Database));
-        Statement = nullptr;
+        return false;
     }
-    return Statement;
-}
 
-static int _GetCount(const char* Table)
-{
-    int Result = 0;
+    bool Short = false;
+    statement_binder(Statement).integer64(OrderNumber);
+    while (StepRow(Statement))
+    {
+        row_reader Reader(Statement);
+        const char* SupplyName = Reader.text();
+        double Used = Reader.decimal();
+        double InStock = Reader.decimal();
+        const char* UnitName = Reader.text();
+
+        Short = true;
+        if (AllowNegative)
+        {
+            BB_LOG_WARN("Order #%" PRId64 " overdraws '%s' (%.2lf of %.2lf %s)",
+                        OrderNumber, SupplyName, Used, InStock, UnitName);
+        }
+        else
+        {
+            BB_LOG_ERROR("Not enough '%s' in stock (%.2lf of %.2lf %s)",
+                         SupplyName, Used, InStock, UnitName);
+        }
+    }
+    ReleaseStatement(Statement);
 
-    char Query[256];
-    snprintf(Query, sizeof(Query), "SELECT COUNT(*) FROM %s;", Table);
+    if (Short && !AllowNegative)
+    {
+        return false;
+    }
 
-    sqlite3_stmt* Statement = Prepare(Query);
-    if (Statement != nullptr && StepRow(Statement))
+    Statement = AcquireStatement(
+        "UPDATE SupplyItem"
+        " SET StockQuantity = StockQuantity - Usage.Used"
+        " FROM (" BB_ORDER_USAGE_QUERY ") AS Usage"
+        " WHERE SupplyItem.SupplyID = Usage.SupplyID");
+
+    bool Result = false;
+    if (Statement != nullptr)
     {
-        Result = sqlite3_column_int(Statement, 0);
+        statement_binder(Statement).integer64(OrderNumber);
+        if (!(Result = _Execute(Statement)))
+        {
+            BB_LOG_ERROR("Failed to deduct stock for OrderNumber = %" PRId64,
+                         OrderNumber);
+        }
     }
 
-    sqlite3_finalize(Statement);
     return Result;
 }
 
-static sqlite3_stmt* _GetList(const char* Table)
+bool CreateOrder(std::vector<order_input>& Items, int64_t* OrderNumberOut)
 {
-    char Query[256];
-    snprintf(Query, sizeof(Query), "SELECT * FROM %s", Table);
-    sqlite3_stmt* Statement = Prepare(Query);
-    return Statement;
-}
+    if (OrderServiceConnected())
+    {
+        return RemoteCreateOrder(Items, OrderNumberOut);
+    }
 
-bool CreateOrder(std::vector<order_input>& Items)
-{
-    sqlite3_stmt* Statement =
-        Prepare("INSERT INTO MenuOrder (OrderDate) VALUES (current_date)");
+    statement Statement = AcquireStatement(
+        "INSERT INTO MenuOrder (OrderDate) VALUES (current_date)");
 
     Transaction();
     bool Result = true;
@@ -180,14 +1049,12 @@ bool CreateOrder(std::vector<order_input>& Items)
     {
         BB_LOG_ERROR("Failed to create a new order.");
     }
-    sqlite3_finalize(Statement);
+    ReleaseStatement(Statement);
 
-    int64_t OrderNumber = LastInsertRowID();
+    int64_t OrderNumber = _LastInsertRowID();
     if (Result)
     {
-        Statement = Prepare(
-            "INSERT INTO MenuOrderItem (OrderNumber, ItemID, OrderQuantity)"
-            "VALUES (?, ?, ?)");
+        Statement = AcquireStatement(S_InsertOrderItem);
 
         if (Statement != nullptr)
         {
@@ -195,7 +1062,7 @@ bool CreateOrder(std::vector<order_input>& Items)
             {
 
                 statement_binder(Statement)
-                    .integer(OrderNumber)
+                    .integer64(OrderNumber)
                     .integer(Input.ItemID)
                     .integer(Input.Quantity);
 
@@ -210,16 +1077,94 @@ bool CreateOrder(std::vector<order_input>& Items)
         }
     }
 
-    sqlite3_finalize(Statement);
+    ReleaseStatement(Statement);
+    if (Result)
+    {
+        Result = _DeductStock(OrderNumber, false) &&
+                 _UpdateDailyItemSales(OrderNumber, 0, 1) &&
+                 _UpdateDailyOrders(OrderNumber, 1);
+    }
+
+    if (Result && OrderNumberOut != nullptr)
+    {
+        *OrderNumberOut = OrderNumber;
+    }
+
     Result ? Commit() : Rollback();
     return Result;
 }
 
+order_importer BeginOrderImport()
+{
+    order_importer Importer = {};
+    Importer.InsertOrder = AcquireStatement(R"(
+        INSERT INTO MenuOrder (OrderDate)
+        VALUES (coalesce(?, current_date))
+    )");
+    Importer.InsertOrderItem = AcquireStatement(S_InsertOrderItem);
+    return Importer;
+}
+
+bool ImportOrder(order_importer& Importer, const char* OrderDate,
+                 const std::vector<order_input>& Items)
+{
+    if (Importer.InsertOrder == nullptr || Importer.InsertOrderItem == nullptr)
+    {
+        return false;
+    }
+
+    statement_binder(Importer.InsertOrder).text(OrderDate);
+    bool Result = _Execute(Importer.InsertOrder);
+    sqlite3_reset(Importer.InsertOrder);
+
+    if (!Result)
+    {
+        BB_LOG_ERROR("Failed to import order dated '%s'",
+                     OrderDate ? OrderDate : "today");
+        return false;
+    }
+
+    int64_t OrderNumber = _LastInsertRowID();
+    for (const order_input& Input : Items)
+    {
+        statement_binder(Importer.InsertOrderItem)
+            .integer64(OrderNumber)
+            .integer(Input.ItemID)
+            .integer(Input.Quantity);
+
+        Result = _Execute(Importer.InsertOrderItem);
+        sqlite3_reset(Importer.InsertOrderItem);
+
+        if (!Result)
+        {
+            BB_LOG_ERROR(
+                "Failed to import ItemID = %i for OrderNumber = %" PRId64,
+                Input.ItemID, OrderNumber);
+            return false;
+        }
+    }
+
+    // Imported sales already happened, so a shortfall is only flagged
+    return _DeductStock(OrderNumber, true) &&
+           _UpdateDailyItemSales(OrderNumber, 0, 1) &&
+           _UpdateDailyOrders(OrderNumber, 1);
+}
+
+void EndOrderImport(order_importer& Importer)
+{
+    ReleaseStatement(Importer.InsertOrder);
+    ReleaseStatement(Importer.InsertOrderItem);
+    Importer = {};
+}
+
 bool AddItemToOrder(int OrderNumber, int ItemID, int ItemQuantity)
 {
-    sqlite3_stmt* Statement =
-        Prepare("INSERT INTO MenuOrderItem (OrderNumber, ItemID, OrderQuantity)"
-                "VALUES (?, ?, ?)");
+    if (OrderServiceConnected())
+    {
+        return RemoteAddItemToOrder(OrderNumber, ItemID, ItemQuantity);
+    }
+
+    statement Statement = AcquireStatement(S_InsertOrderItem);
 
     bool Result = false;
     if (Statement != nullptr)
@@ -229,8 +1174,7 @@ bool AddItemToOrder(int OrderNumber, int ItemID, int ItemQuantity)
         Result = _Execute(Statement);
     }
 
-    sqlite3_finalize(Statement);
-    return Result;
+    return Result && _UpdateDailyItemSales(OrderNumber, ItemID, 1);
 }
 
 int GetOrderCount()
@@ -239,10 +1183,10 @@ int GetOrderCount()
     return Result;
 }
 
-sqlite3_stmt* GetOrder(int OrderNumber)
+statement GetOrder(int OrderNumber)
 {
-    sqlite3_stmt* Statement =
-        Prepare("SELECT * FROM MenuOrder WHERE OrderNumber = ?");
+    statement Statement =
+        AcquireStatement("SELECT * FROM MenuOrder WHERE OrderNumber = ?");
 
     if (Statement != nullptr)
     {
@@ -252,70 +1196,119 @@ sqlite3_stmt* GetOrder(int OrderNumber)
         {
             BB_LOG_ERROR("Failed to retrieve MenuOrder with OrderNumber = %i",
                          OrderNumber);
-            sqlite3_finalize(Statement);
-            Statement = nullptr;
+            ReleaseStatement(Statement);
         }
     }
 
     return Statement;
 }
 
-sqlite3_stmt* GetOrderList()
+statement GetOrderList()
 {
     return _GetList("MenuOrder");
 }
 
-bool DeleteOrder(int OrderNumber)
+keyset_pager GetOrderPreviewPager()
 {
-    Transaction();
-    sqlite3_stmt* OrderItemList = GetOrderItemList(OrderNumber);
+    // One row per order with its lines already folded into a single column,
+    // so a page of orders costs one statement instead of one per order.
+    return _CreatePager(R"(
+        SELECT
+        PageOrder.OrderNumber,
+        PageOrder.OrderDate,
+        group_concat('x' || MenuOrderItem.OrderQuantity || ' - ' ||
+                     Item.ItemName, ' ')
+        FROM (
+            SELECT *
+            FROM MenuOrder
+            WHERE OrderNumber > ?
+            ORDER BY OrderNumber
+            LIMIT ?
+        ) AS PageOrder
+        LEFT JOIN MenuOrderItem
+            ON MenuOrderItem.OrderNumber = PageOrder.OrderNumber
+        LEFT JOIN Item ON MenuOrderItem.ItemID = Item.ItemID
+        GROUP BY PageOrder.OrderNumber
+        ORDER BY PageOrder.OrderNumber
+    )", 0);
+}
 
-    bool Result = true;
-    while (StepRow(OrderItemList))
+bool DeleteOrder(int OrderNumber, delete_counts* Counts)
+{
+    if (OrderServiceConnected())
     {
-        int ItemID = row_reader(OrderItemList, 1).integer();
-        if (!DeleteOrderItem(OrderNumber, ItemID))
-        {
-            Result = false;
-            break;
-        }
+        return RemoteDeleteOrder(OrderNumber, Counts);
     }
 
-    sqlite3_stmt* DeleteOrderStatement = nullptr;
-    if (Result)
+    delete_counts Deleted = {};
+
+    Transaction();
+    bool Result = _UpdateDailyItemSales(OrderNumber, 0, -1) &&
+                  _UpdateDailyOrders(OrderNumber, -1) &&
+                  _DeleteRows("DELETE FROM MenuOrderItem WHERE OrderNumber = ?",
+                              OrderNumber, Deleted.OrderItems) &&
+                  _DeleteRows("DELETE FROM MenuOrder WHERE OrderNumber = ?",
+                              OrderNumber, Deleted.Orders);
+
+    if (!Result)
     {
-        DeleteOrderStatement =
-            Prepare("DELETE FROM MenuOrder WHERE OrderNumber = ?");
+        BB_LOG_ERROR("Failed to delete order with OrderNumber = %i",
+                     OrderNumber);
+    }
 
-        if (DeleteOrderStatement != nullptr)
-        {
-            statement_binder(DeleteOrderStatement).integer(OrderNumber);
-            if (!(Result = _Execute(DeleteOrderStatement)))
-            {
-                BB_LOG_ERROR("Failed to delete order with OrderNumber = %i",
-                             OrderNumber);
-            }
-        }
+    Result ? Commit() : Rollback();
+    if (Result && Counts != nullptr)
+    {
+        *Counts = Deleted;
     }
+    return Result;
+}
 
-    if (Result)
+bool DeleteOrders(const std::vector<int>& OrderNumbers, delete_counts* Counts)
+{
+    if (OrderServiceConnected())
     {
-        Commit();
+        return RemoteDeleteOrders(OrderNumbers, Counts);
     }
-    else
+
+    Transaction();
+    bool Result = _SetDeleteKeys(OrderNumbers) && _DeleteOrderKeys(Counts);
+    Result ? Commit() : Rollback();
+    return Result;
+}
+
+bool DeleteOrdersByDate(const char* From, const char* To,
+                        delete_counts* Counts)
+{
+    if (OrderServiceConnected())
     {
-        Rollback();
+        return RemoteDeleteOrdersByDate(From, To, Counts);
     }
 
-    sqlite3_finalize(DeleteOrderStatement);
-    sqlite3_finalize(OrderItemList);
+    Transaction();
+    bool Result = _SetDeleteKeys({});
+    statement Statement = AcquireStatement(R"(
+        INSERT INTO temp.DeleteKeys
+        SELECT OrderNumber
+        FROM MenuOrder
+        WHERE OrderDate BETWEEN coalesce(?1, '') AND coalesce(?2, '9999')
+    )");
+
+    if (Result && (Result = Statement != nullptr))
+    {
+        statement_binder(Statement).text(From).text(To);
+        Result = _Execute(Statement);
+    }
+    ReleaseStatement(Statement);
 
+    Result = Result && _DeleteOrderKeys(Counts);
+    Result ? Commit() : Rollback();
     return Result;
 }
 
 int GetOrderSize(int OrderNumber)
 {
-    sqlite3_stmt* Statement = Prepare(R"(
+    statement Statement = AcquireStatement(R"(
         SELECT COUNT(*)
         FROM MenuOrderItem
         WHERE OrderNumber = ?
@@ -334,10 +1327,10 @@ int GetOrderSize(int OrderNumber)
     return Result;
 }
 
-sqlite3_stmt* GetOrderItemList(int OrderNumber)
+statement GetOrderItemList(int OrderNumber)
 {
-    sqlite3_stmt* Statement =
-        Prepare("SELECT * FROM MenuOrderItem WHERE OrderNumber = ?");
+    statement Statement =
+        AcquireStatement("SELECT * FROM MenuOrderItem WHERE OrderNumber = ?");
     if (Statement != nullptr)
     {
         statement_binder(Statement).integer(OrderNumber);
@@ -345,9 +1338,9 @@ sqlite3_stmt* GetOrderItemList(int OrderNumber)
     return Statement;
 }
 
-sqlite3_stmt* GetOrderItemPreviewList(int OrderNumber)
+statement GetOrderItemPreviewList(int OrderNumber)
 {
-    sqlite3_stmt* Statement = Prepare(R"(
+    statement Statement = AcquireStatement(R"(
         SELECT
         MenuOrderItem.OrderQuantity,
         Item.ItemID,
@@ -365,10 +1358,32 @@ sqlite3_stmt* GetOrderItemPreviewList(int OrderNumber)
     return Statement;
 }
 
+keyset_pager GetOrderItemPreviewPager(int OrderNumber)
+{
+    keyset_pager Pager = _CreatePager(R"(
+        SELECT
+        MenuOrderItem.OrderQuantity,
+        Item.ItemID,
+        Item.ItemName
+        FROM MenuOrderItem
+        JOIN Item ON MenuOrderItem.ItemID = Item.ItemID
+        WHERE MenuOrderItem.OrderNumber = ? AND MenuOrderItem.ItemID > ?
+        ORDER BY MenuOrderItem.ItemID
+        LIMIT ?
+    )", 1);
+
+    if (Pager.Statement != nullptr)
+    {
+        statement_binder(Pager.Statement).integer(OrderNumber);
+    }
+
+    return Pager;
+}
+
 int GetOrderItemCount(int OrderNumber)
 {
-    sqlite3_stmt* Statement =
-        Prepare("SELECT COUNT(*) FROM MenuOrderItem WHERE OrderNumber = ?");
+    statement Statement = AcquireStatement(
+        "SELECT COUNT(*) FROM MenuOrderItem WHERE OrderNumber = ?");
 
     int Result = 0;
     if (Statement != nullptr)
@@ -381,13 +1396,12 @@ int GetOrderItemCount(int OrderNumber)
         }
     }
 
-    sqlite3_finalize(Statement);
     return Result;
 }
 
-sqlite3_stmt* GetOrderItem(int OrderNumber, int ItemID)
+statement GetOrderItem(int OrderNumber, int ItemID)
 {
-    sqlite3_stmt* Statement = Prepare(R"(
+    statement Statement = AcquireStatement(R"(
         SELECT * 
         FROM MenuOrderItem
         WHERE OrderNumber = ? AND ItemID = ?
@@ -403,8 +1417,7 @@ sqlite3_stmt* GetOrderItem(int OrderNumber, int ItemID)
                          "%i, ItemID = %i",
                          OrderNumber, ItemID);
 
-            sqlite3_finalize(Statement);
-            Statement = nullptr;
+            ReleaseStatement(Statement);
         }
     }
 
@@ -413,14 +1426,21 @@ sqlite3_stmt* GetOrderItem(int OrderNumber, int ItemID)
 
 bool UpdateOrderItem(int OrderNumber, int ItemID, int Quantity)
 {
-    sqlite3_stmt* Statement = Prepare(R"(
+    if (OrderServiceConnected())
+    {
+        return RemoteUpdateOrderItem(OrderNumber, ItemID, Quantity);
+    }
+
+    statement Statement = AcquireStatement(R"(
         UPDATE MenuOrderItem
         SET OrderQuantity = ?
         WHERE OrderNumber = ? AND ItemID = ?
     )");
 
+    Transaction();
     bool Result = false;
-    if (Statement != nullptr)
+    if (Statement != nullptr &&
+        _UpdateDailyItemSales(OrderNumber, ItemID, -1))
     {
         statement_binder(Statement)
             .integer(Quantity)
@@ -435,17 +1455,26 @@ bool UpdateOrderItem(int OrderNumber, int ItemID, int Quantity)
         }
     }
 
-    sqlite3_finalize(Statement);
+    ReleaseStatement(Statement);
+    Result = Result && _UpdateDailyItemSales(OrderNumber, ItemID, 1);
+    Result ? Commit() : Rollback();
     return Result;
 }
 
 bool DeleteOrderItem(int OrderNumber, int ItemID)
 {
-    sqlite3_stmt* Statement = Prepare(
+    if (OrderServiceConnected())
+    {
+        return RemoteDeleteOrderItem(OrderNumber, ItemID);
+    }
+
+    statement Statement = AcquireStatement(
         "DELETE FROM MenuOrderItem WHERE OrderNumber = ? AND ItemID = ?");
 
+    Transaction();
     bool Result = false;
-    if (Statement != nullptr)
+    if (Statement != nullptr &&
+        _UpdateDailyItemSales(OrderNumber, ItemID, -1))
     {
         statement_binder(Statement).integer(OrderNumber).integer(ItemID);
         if (!(Result = _Execute(Statement)))
@@ -456,12 +1485,15 @@ bool DeleteOrderItem(int OrderNumber, int ItemID)
         }
     }
 
+    ReleaseStatement(Statement);
+    Result ? Commit() : Rollback();
     return Result;
 }
 
-sqlite3_stmt* GetItem(int ItemID)
+statement GetItem(int ItemID)
 {
-    sqlite3_stmt* Statement = Prepare("SELECT * FROM Item WHERE ItemID = ?");
+    statement Statement =
+        AcquireStatement("SELECT * FROM Item WHERE ItemID = ?");
 
     if (Statement != nullptr)
     {
@@ -470,8 +1502,7 @@ sqlite3_stmt* GetItem(int ItemID)
         if (!StepRow(Statement))
         {
             BB_LOG_ERROR("Failed to retrieve Item with ItemID = %i", ItemID);
-            sqlite3_finalize(Statement);
-            Statement = nullptr;
+            ReleaseStatement(Statement);
         }
     }
 
@@ -484,23 +1515,35 @@ int GetItemCount()
     return Result;
 }
 
-sqlite3_stmt* GetItemList()
+statement GetItemList()
 {
-    sqlite3_stmt* Result = _GetList("Item");
+    statement Result = _GetList("Item");
     return Result;
 }
 
+keyset_pager GetItemPager()
+{
+    return _GetPager("Item", "ItemID");
+}
+
 bool CreateItem(const char* ItemName, const char* ItemDescription,
-                double ItemPrice, const std::vector<ingredient>& Ingredients)
+                double ItemPrice, const std::vector<ingredient>& Ingredients,
+                int64_t* ItemIDOut)
 {
+    if (OrderServiceConnected())
+    {
+        return RemoteCreateItem(ItemName, ItemDescription, ItemPrice,
+                                Ingredients, ItemIDOut);
+    }
+
     bool Result = true;
-    sqlite3_stmt* Statement = Prepare(R"(
+    statement Statement = AcquireStatement(R"(
         INSERT INTO Item (ItemName, ItemDescription, ItemPrice)
         VALUES (?, ?, ?)
     )");
 
     Transaction();
-    int64_t ItemID;
+    int64_t ItemID = 0;
     if (Statement != nullptr)
     {
         statement_binder(Statement)
@@ -514,13 +1557,13 @@ bool CreateItem(const char* ItemName, const char* ItemDescription,
         }
     }
 
-    sqlite3_finalize(Statement);
+    ReleaseStatement(Statement);
     if (Result)
     {
         Result = true;
-        ItemID = LastInsertRowID();
+        ItemID = _LastInsertRowID();
 
-        Statement = Prepare(R"(
+        Statement = AcquireStatement(R"(
             INSERT INTO Ingredient (ItemID, SupplyID, Quantity)
             VALUES (?, ?, ?)
         )");
@@ -547,15 +1590,21 @@ bool CreateItem(const char* ItemName, const char* ItemDescription,
         }
     }
 
-    sqlite3_finalize(Statement);
+    ReleaseStatement(Statement);
+    if (Result && ItemIDOut != nullptr)
+    {
+        *ItemIDOut = ItemID;
+    }
+
     Result ? Commit() : Rollback();
+    InvalidateCatalog();
     return Result;
 }
 
 int GetIngredientCount(int ItemID)
 {
     int Result = 0;
-    sqlite3_stmt* Statement = Prepare(R"(
+    statement Statement = AcquireStatement(R"(
         SELECT COUNT(*)
         FROM Ingredient
         WHERE ItemID = ?
@@ -571,14 +1620,18 @@ int GetIngredientCount(int ItemID)
         }
     }
 
-    sqlite3_finalize(Statement);
     return Result;
 }
 
 bool DeleteIngredient(int ItemID, int SupplyID)
 {
-    sqlite3_stmt* Statement =
-        Prepare("DELETE FROM Ingredient WHERE ItemID = ? AND SupplyID = ?");
+    if (OrderServiceConnected())
+    {
+        return RemoteDeleteIngredient(ItemID, SupplyID);
+    }
+
+    statement Statement = AcquireStatement(
+        "DELETE FROM Ingredient WHERE ItemID = ? AND SupplyID = ?");
 
     bool Result = false;
     if (Statement != nullptr)
@@ -593,14 +1646,21 @@ bool DeleteIngredient(int ItemID, int SupplyID)
         }
     }
 
+    ReleaseStatement(Statement);
+    InvalidateCatalog();
     return Result;
 }
 
 bool UpdateIngredient(int ItemID, int SupplyID, double Quantity)
 {
+    if (OrderServiceConnected())
+    {
+        return RemoteUpdateIngredient(ItemID, SupplyID, Quantity);
+    }
+
     bool Result = false;
 
-    sqlite3_stmt* Statement = Prepare(R"(
+    statement Statement = AcquireStatement(R"(
         UPDATE Ingredient 
         SET Quantity = ? 
         WHERE ItemID = ? AND SupplyID = ?
@@ -619,49 +1679,94 @@ bool UpdateIngredient(int ItemID, int SupplyID, double Quantity)
         }
     }
 
+    ReleaseStatement(Statement);
+    InvalidateCatalog();
     return Result;
 }
 
-bool DeleteItem(int ItemID)
+bool DeleteItem(int ItemID, delete_counts* Counts)
 {
-    bool Result = true;
-    sqlite3_stmt* Statement = GetIngredientList(ItemID);
+    if (OrderServiceConnected())
+    {
+        return RemoteDeleteItem(ItemID, Counts);
+    }
 
-    if (Statement != nullptr)
+    delete_counts Deleted = {};
+
+    Transaction();
+    bool Result = _DeleteRows("DELETE FROM Ingredient WHERE ItemID = ?", ItemID,
+                              Deleted.Ingredients) &&
+                  _DeleteRows("DELETE FROM Item WHERE ItemID = ?", ItemID,
+                              Deleted.Items);
+
+    if (!Result)
     {
-        statement_binder(Statement).integer(ItemID);
-        while (StepRow(Statement))
-        {
-            int SupplyID = row_reader(Statement, 1).integer();
-            if (!(Result = DeleteIngredient(ItemID, SupplyID)))
-            {
-                break; 
-            }
-        }
+        BB_LOG_ERROR("Failed to delete item. ItemID = %i", ItemID);
     }
-    sqlite3_finalize(Statement);
-    
-    Statement = Prepare("DELETE FROM Item WHERE ItemID = ?");
-    if (Result)
+
+    Result ? Commit() : Rollback();
+    InvalidateCatalog();
+    if (Result && Counts != nullptr)
     {
-        if (Statement != nullptr)
-        {
-            statement_binder(Statement).integer(ItemID);
-            if (!(Result = _Execute(Statement)))
-            {
-                BB_LOG_ERROR("Failed to delete item. ItemID = %i", ItemID);
-            }
-        }
+        *Counts = Deleted;
+    }
+    return Result;
+}
+
+bool DeleteItems(const std::vector<int>& ItemIDs, delete_counts* Counts)
+{
+    if (OrderServiceConnected())
+    {
+        return RemoteDeleteItems(ItemIDs, Counts);
     }
 
+    delete_counts Deleted = {};
+
+    Transaction();
+    bool Result =
+        _SetDeleteKeys(ItemIDs) &&
+        _DeleteRows("DELETE FROM Ingredient"
+                    " WHERE ItemID IN (SELECT Key FROM temp.DeleteKeys)",
+                    0, Deleted.Ingredients) &&
+        _DeleteRows("DELETE FROM Item"
+                    " WHERE ItemID IN (SELECT Key FROM temp.DeleteKeys)",
+                    0, Deleted.Items);
+
     Result ? Commit() : Rollback();
-    sqlite3_finalize(Statement);
+    InvalidateCatalog();
+    if (Result && Counts != nullptr)
+    {
+        *Counts = Deleted;
+    }
     return Result;
 }
 
-sqlite3_stmt* GetIngredientList(int ItemID)
+statement GetIngredientList(int ItemID)
+{
+    statement Statement =
+        AcquireStatement("SELECT * FROM Ingredient WHERE ItemID = ?");
+
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement).integer(ItemID);
+    }
+
+    return Statement;
+}
+
+statement GetIngredientDetailList(int ItemID)
 {
-    sqlite3_stmt* Statement = Prepare("SELECT * FROM Ingredient WHERE ItemID = ?");
+    statement Statement = AcquireStatement(R"(
+        SELECT
+        Ingredient.SupplyID,
+        SupplyItem.SupplyName,
+        Ingredient.Quantity,
+        SupplyItem.UnitName
+        FROM Ingredient
+        JOIN SupplyItem ON Ingredient.SupplyID = SupplyItem.SupplyID
+        WHERE Ingredient.ItemID = ?
+        ORDER BY Ingredient.SupplyID
+    )");
 
     if (Statement != nullptr)
     {
@@ -671,9 +1776,38 @@ sqlite3_stmt* GetIngredientList(int ItemID)
     return Statement;
 }
 
-bool CreateSupply(const char* SupplyName, const char* UnitName, int Quantity)
+keyset_pager GetIngredientDetailPager(int ItemID)
+{
+    keyset_pager Pager = _CreatePager(R"(
+        SELECT
+        Ingredient.SupplyID,
+        SupplyItem.SupplyName,
+        Ingredient.Quantity,
+        SupplyItem.UnitName
+        FROM Ingredient
+        JOIN SupplyItem ON Ingredient.SupplyID = SupplyItem.SupplyID
+        WHERE Ingredient.ItemID = ? AND Ingredient.SupplyID > ?
+        ORDER BY Ingredient.SupplyID
+        LIMIT ?
+    )", 0);
+
+    if (Pager.Statement != nullptr)
+    {
+        statement_binder(Pager.Statement).integer(ItemID);
+    }
+
+    return Pager;
+}
+
+bool CreateSupply(const char* SupplyName, const char* UnitName, int Quantity,
+                  int64_t* SupplyIDOut)
 {
-    sqlite3_stmt* Statement = Prepare(R"(
+    if (OrderServiceConnected())
+    {
+        return RemoteCreateSupply(SupplyName, UnitName, Quantity, SupplyIDOut);
+    }
+
+    statement Statement = AcquireStatement(R"(
         INSERT INTO SupplyItem(SupplyName, StockQuantity, UnitName)
         VALUES (?, ?, ?)
     )");
@@ -690,18 +1824,25 @@ bool CreateSupply(const char* SupplyName, const char* UnitName, int Quantity)
         {
             BB_LOG_ERROR(
                 "Failed to create a supply item from\n"
-                "\t SupplyName = %s, StockQuantity = %s, UnitName = %s",
+                "\t SupplyName = %s, StockQuantity = %i, UnitName = %s",
                 SupplyName, Quantity, UnitName);
         }
     }
 
+    if (Result && SupplyIDOut != nullptr)
+    {
+        *SupplyIDOut = _LastInsertRowID();
+    }
+
+    ReleaseStatement(Statement);
+    InvalidateCatalog();
     return Result;
 }
 
-sqlite3_stmt* GetSupplyItem(int SupplyID)
+statement GetSupplyItem(int SupplyID)
 {
-    sqlite3_stmt* Statement =
-        Prepare("SELECT * FROM SupplyItem WHERE SupplyID = ?");
+    statement Statement =
+        AcquireStatement("SELECT * FROM SupplyItem WHERE SupplyID = ?");
 
     if (Statement != nullptr)
     {
@@ -711,17 +1852,23 @@ sqlite3_stmt* GetSupplyItem(int SupplyID)
         {
             BB_LOG_ERROR("Failed to find SupplyItem with SupplyID = %i",
                          SupplyID);
+            ReleaseStatement(Statement);
         }
     }
 
     return Statement;
 }
 
-sqlite3_stmt* GetSupplyList()
+statement GetSupplyList()
 {
     return _GetList("SupplyItem");
 }
 
+keyset_pager GetSupplyPager()
+{
+    return _GetPager("SupplyItem", "SupplyID");
+}
+
 int GetSupplyCount()
 {
     return _GetCount("SupplyItem");
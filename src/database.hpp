@@ -16,7 +16,52 @@
 #include <cstdint>
 #include <vector>
 
-extern sqlite3* Database;
+// A SQLite connection and the statements compiled on it, used by one thread
+// at a time. There is one writer connection and a pool of read-only ones.
+struct database_connection;
+
+// Owns a statement handed out by AcquireStatement() and gives it back to the
+// cache when it goes out of scope. Only a named handle converts to the raw
+// pointer, so the result of a Get*() call can't be read after it's released.
+struct statement
+{
+    statement();
+    explicit statement(sqlite3_stmt* Statement);
+    statement(statement&& Other);
+    statement& operator=(statement&& Other);
+    statement(const statement&) = delete;
+    statement& operator=(const statement&) = delete;
+    ~statement();
+
+    operator sqlite3_stmt*() const& { return Statement; }
+    operator sqlite3_stmt*() const&& = delete;
+
+        private:
+    sqlite3_stmt* Statement;
+    database_connection* Connection; // The one it goes back to
+    friend void ReleaseStatement(statement& Statement);
+};
+
+// Binds a read-only connection from the pool to the calling thread for as
+// long as it lives, so every read below runs on it instead of the writer
+// connection. Connections are opened on first use, up to the profile's
+// ReadConnections, after that a lease waits for one to come back. False if
+// none could be had, or inside the thread's own write transaction, and reads
+// then stay on the thread's connection. Statements from the lease must be
+// released before it.
+struct reader_lease
+{
+    reader_lease();
+    reader_lease(const reader_lease&) = delete;
+    reader_lease& operator=(const reader_lease&) = delete;
+    ~reader_lease();
+
+    explicit operator bool() const { return Connection != nullptr; }
+
+        private:
+    database_connection* Connection;
+    database_connection* Previous;
+};
 
 struct row_reader
 {
@@ -35,6 +80,7 @@ struct statement_binder
 {
     statement_binder(sqlite3_stmt* Statement);
     statement_binder& integer(int Value);
+    statement_binder& integer64(int64_t Value);
     statement_binder& decimal(double Value);
     statement_binder& text(const char* Text);
 
@@ -43,6 +89,62 @@ struct statement_binder
     sqlite3_stmt* Statement;
 };
 
+// Pragmas applied to the connection when it is opened. "register" keeps
+// commits short for order entry, "reporting" favours long read-only scans.
+struct connection_profile
+{
+    const char* Name;
+    const char* JournalMode;
+    const char* Synchronous;
+    int CacheSize;   // PRAGMA cache_size, negative values are KiB
+    int64_t MmapSize; // Bytes, 0 disables memory mapping
+    const char* TempStore;
+    int BusyTimeout; // Milliseconds
+    int ReadConnections; // Size of the reader_lease pool
+};
+
+struct statement_cache_stats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Cached;
+};
+
+// Keyset pagination over a query whose last two parameters are the boundary
+// key and the page size, e.g. "WHERE Key > ? ORDER BY Key LIMIT ?". The
+// boundary key before every visited page is remembered so moving back a page
+// is a single indexed seek instead of a rewind-and-skip. Under WAL the pager
+// reads on a connection taken from the reader pool until ClosePager(), when
+// one is free, and otherwise on the calling thread's connection.
+struct keyset_pager
+{
+    statement Statement;
+    database_connection* Reader;
+    int KeyColumn;
+    int RowsPerPage;
+    int RowsFetched;
+    int Page;
+    int LastKey;
+    std::vector<int> PageStarts;
+};
+
+// Holds the MenuOrder/MenuOrderItem inserts open across a bulk import so each
+// order only binds and steps them. Transactions are left to the caller.
+struct order_importer
+{
+    statement InsertOrder;
+    statement InsertOrderItem;
+};
+
+// Rows removed by a delete, per table
+struct delete_counts
+{
+    int64_t Orders;
+    int64_t OrderItems;
+    int64_t Items;
+    int64_t Ingredients;
+};
+
 struct ingredient
 {
     int SupplyID;
@@ -55,50 +157,110 @@ struct order_input
     int Quantity;
 };
 
-bool DatabaseInit(const char* FileName);
+extern const connection_profile RegisterProfile;
+extern const connection_profile ReportingProfile;
+
+// Returns nullptr if there is no profile called Name
+const connection_profile* FindConnectionProfile(const char* Name);
+
+// Opens the writer connection. Threads without a reader_lease all use it and
+// must take turns, the UI thread or the order service's writer thread.
+bool DatabaseInit(const char* FileName, const connection_profile& Profile);
+// Closes every connection, no reader_lease may still be held
 void DatabaseClose();
+// The connection the calling thread runs its queries on, nullptr when closed
+sqlite3* DatabaseHandle();
 
-// Utility
+// Utility. The IDs of created rows come back from the Create*() calls, the
+// connection's last insert rowid is not part of the API.
 void Transaction();
 void Commit();
 void Rollback();
-int64_t LastInsertRowID();
 bool StepRow(sqlite3_stmt* Cursor);
-bool Prepare(sqlite3_stmt* Cursor);
+sqlite3_stmt* Prepare(const char* Query);
+
+// Statement cache. Acquired statements come back reset with no bindings and
+// return to the cache when their handle is destroyed. ReleaseStatement()
+// gives one back early and leaves the handle empty. Debug builds report any
+// handle still open at DatabaseClose() with the SQL that created it. Each
+// connection has its own cache, the stats are for the calling thread's.
+statement AcquireStatement(const char* Query);
+void ReleaseStatement(statement& Statement);
+// Disabling makes every acquire compile a fresh statement, for benchmarking
+// the cache. Statements already cached stay cached.
+void SetStatementCaching(bool Enabled);
+statement_cache_stats GetStatementCacheStats();
+
+// Paging
+void SetPageSize(keyset_pager& Pager, int RowsPerPage);
+bool FetchPage(keyset_pager& Pager);
+bool StepPage(keyset_pager& Pager);
+bool NextPage(keyset_pager& Pager);
+bool PreviousPage(keyset_pager& Pager);
+void ClosePager(keyset_pager& Pager);
 
 // Order/MenuOrder
-bool CreateOrder(std::vector<order_input>& Items);
+// Deducts the supplies the order uses from stock in the same transaction and
+// refuses the order if any supply would go negative.
+bool CreateOrder(std::vector<order_input>& Items,
+                 int64_t* OrderNumber = nullptr);
 bool AddItemToOrder(int OrderNumber, int ItemID, int ItemQuantity);
 int GetOrderCount();
-sqlite3_stmt* GetOrder(int OrderNumber);
-sqlite3_stmt* GetOrderList();
+statement GetOrder(int OrderNumber);
+statement GetOrderList();
+keyset_pager GetOrderPreviewPager();
 int GetOrderSize(int OrderNumber);
-bool DeleteOrder(int OrderNumber);
+bool DeleteOrder(int OrderNumber, delete_counts* Counts = nullptr);
+// Batch deletes run in one transaction. The date range is inclusive and a
+// nullptr end leaves it open.
+bool DeleteOrders(const std::vector<int>& OrderNumbers,
+                  delete_counts* Counts = nullptr);
+bool DeleteOrdersByDate(const char* From, const char* To,
+                        delete_counts* Counts = nullptr);
+
+// Bulk import, OrderDate may be nullptr for the current date. Stock is
+// deducted like CreateOrder but shortfalls are only logged as warnings.
+order_importer BeginOrderImport();
+bool ImportOrder(order_importer& Importer, const char* OrderDate,
+                 const std::vector<order_input>& Items);
+void EndOrderImport(order_importer& Importer);
 
 // MenuOrderItem
-sqlite3_stmt* GetOrderItemList(int OrderNumber);
-sqlite3_stmt* GetOrderItemPreviewList(int OrderNumber);
+statement GetOrderItemList(int OrderNumber);
+statement GetOrderItemPreviewList(int OrderNumber);
+keyset_pager GetOrderItemPreviewPager(int OrderNumber);
 int GetOrderItemCount(int OrderNumber);
-sqlite3_stmt* GetOrderItem(int OrderNumber, int ItemID);
+statement GetOrderItem(int OrderNumber, int ItemID);
 bool UpdateOrderItem(int OrderNumber, int ItemID, int Quantity);
 bool DeleteOrderItem(int OrderNumber, int ItemID);
 
 // Item
-sqlite3_stmt* GetItem(int ItemID);
+statement GetItem(int ItemID);
 int GetItemCount();
-sqlite3_stmt* GetItemList();
+statement GetItemList();
+keyset_pager GetItemPager();
 bool CreateItem(const char* ItemName, const char* ItemDescription,
-                double ItemPrice, const std::vector<ingredient>& Ingredients);
+                double ItemPrice, const std::vector<ingredient>& Ingredients,
+                int64_t* ItemID = nullptr);
 
 //Ingredient
 int GetIngredientCount(int ItemID);
-bool DeleteItem(int ItemID);
+bool DeleteItem(int ItemID, delete_counts* Counts = nullptr);
+bool DeleteItems(const std::vector<int>& ItemIDs,
+                 delete_counts* Counts = nullptr);
 bool DeleteIngredient(int ItemID, int SupplyID);
 bool UpdateIngredient(int ItemID, int SupplyID, double Quantity);
-sqlite3_stmt* GetIngredientList(int ItemID);
+statement GetIngredientList(int ItemID);
+
+// Ingredient JOIN SupplyItem, rows are (SupplyID, SupplyName, Quantity,
+// UnitName)
+statement GetIngredientDetailList(int ItemID);
+keyset_pager GetIngredientDetailPager(int ItemID);
 
 // Supply
-bool CreateSupply(const char* SupplyName, const char* UnitName, int Quantity);
-sqlite3_stmt* GetSupplyItem(int SupplyID);
-sqlite3_stmt* GetSupplyList();
+bool CreateSupply(const char* SupplyName, const char* UnitName, int Quantity,
+                  int64_t* SupplyID = nullptr);
+statement GetSupplyItem(int SupplyID);
+statement GetSupplyList();
+keyset_pager GetSupplyPager();
 int GetSupplyCount();
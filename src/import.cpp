@@ -0,0 +1,141 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: import.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Bulk load register exports into the database.
+ */
+
+#include "import.hpp"
+#include "database.hpp"
+#include <chrono>
+#include <ctype.h>
+#include <string.h>
+#include <vector>
+
+struct pending_order
+{
+    int Key;
+    char Date[32];
+    std::vector<order_input> Items;
+};
+
+bool ImportOrders(FILE* Stream, int OrdersPerTransaction)
+{
+    auto Start = std::chrono::steady_clock::now();
+
+    order_importer Importer = BeginOrderImport();
+    pending_order Pending = {};
+
+    long OrderCount = 0;
+    long LineCount = 0;
+    long BatchOrders = 0;
+    long BatchLines = 0;
+    bool InTransaction = false;
+    bool Result = true;
+
+    auto CommitBatch = [&]() {
+        Commit();
+        InTransaction = false;
+        OrderCount += BatchOrders;
+        LineCount += BatchLines;
+        BatchOrders = 0;
+        BatchLines = 0;
+    };
+
+    auto FlushOrder = [&]() {
+        if (Pending.Items.empty())
+        {
+            return true;
+        }
+
+        if (!InTransaction)
+        {
+            Transaction();
+            InTransaction = true;
+        }
+
+        const char* Date = Pending.Date[0] ? Pending.Date : nullptr;
+        if (!ImportOrder(Importer, Date, Pending.Items))
+        {
+            return false;
+        }
+
+        BatchOrders++;
+        BatchLines += Pending.Items.size();
+        Pending.Items.clear();
+
+        if (BatchOrders >= OrdersPerTransaction)
+        {
+            CommitBatch();
+        }
+        return true;
+    };
+
+    char Line[256];
+    long LineNumber = 0;
+    while (Result && fgets(Line, sizeof(Line), Stream))
+    {
+        LineNumber++;
+        if (Line[0] == '#' || Line[0] == '\n' || Line[0] == '\r' ||
+            (LineNumber == 1 && !isdigit((unsigned char)Line[0])))
+        {
+            continue;
+        }
+
+        int Key;
+        order_input Input;
+        char Date[32] = {};
+        int Fields = sscanf(Line, "%d,%d,%d,%31[^,\r\n]", &Key, &Input.ItemID,
+                            &Input.Quantity, Date);
+
+        if (Fields < 3 || Input.Quantity <= 0)
+        {
+            fprintf(stderr, "Skipping malformed line %li: %s", LineNumber,
+                    Line);
+            continue;
+        }
+
+        if (!Pending.Items.empty() && Key != Pending.Key)
+        {
+            Result = FlushOrder();
+        }
+
+        Pending.Key = Key;
+        strcpy(Pending.Date, Date);
+        Pending.Items.push_back(Input);
+    }
+
+    if (Result)
+    {
+        Result = FlushOrder();
+    }
+
+    if (InTransaction)
+    {
+        Result ? CommitBatch() : Rollback();
+    }
+
+    EndOrderImport(Importer);
+
+    double Seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+    long Rows = OrderCount + LineCount;
+
+    printf("Imported %li orders (%li rows) in %.3lfs, %.0lf rows/sec\n",
+           OrderCount, Rows, Seconds, Seconds > 0 ? Rows / Seconds : 0.0);
+
+    if (!Result)
+    {
+        fprintf(stderr, "Import stopped at line %li, the batch in progress "
+                        "was rolled back.\n",
+                LineNumber);
+    }
+
+    return Result;
+}
@@ -0,0 +1,30 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: import.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Bulk load register exports into the database.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+/*
+ * Reads CSV lines of the form
+ *
+ *     OrderKey,ItemID,Quantity[,OrderDate]
+ *
+ * where consecutive lines sharing an OrderKey make up one order. The key only
+ * groups lines, every order gets a fresh OrderNumber. OrderDate is
+ * 'YYYY-MM-DD' and defaults to today. Blank lines, lines starting with '#' and
+ * a leading header line are skipped.
+ *
+ * Orders are committed OrdersPerTransaction at a time. A failed insert rolls
+ * back the batch it belongs to and stops the import.
+ */
+bool ImportOrders(FILE* Stream, int OrdersPerTransaction);
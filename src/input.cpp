@@ -11,10 +11,63 @@
 
 #include "input.hpp"
 #include "logger.hpp"
+#include "terminal.hpp"
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
 
+input_pattern CreateInputPattern(const char* Class, bool AllowCancel)
+{
+    input_pattern Pattern = {};
+    Pattern.AllowCancel = AllowCancel;
+
+    for (const unsigned char* Character = (const unsigned char*)Class;
+         *Character; Character++)
+    {
+        if (Character[1] == '-' && Character[2] != '\0')
+        {
+            for (int Range = Character[0]; Range <= Character[2]; Range++)
+            {
+                Pattern.Allowed[Range] = 1;
+            }
+            Character += 2;
+        }
+        else
+        {
+            Pattern.Allowed[*Character] = 1;
+        }
+    }
+
+    return Pattern;
+}
+
+bool MatchPattern(const std::string& Input, const input_pattern& Pattern)
+{
+    if (Input.empty())
+    {
+        return false;
+    }
+
+    if (Pattern.AllowCancel && Input == "-1")
+    {
+        return true;
+    }
+
+    for (unsigned char Character : Input)
+    {
+        if (!Pattern.Allowed[Character])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const input_pattern NamePattern = CreateInputPattern("A-Za-z ", true);
+const input_pattern UnitPattern = CreateInputPattern("A-Za-z ", true);
+const input_pattern DescriptionPattern = CreateInputPattern("A-Za-z .,", true);
+
 static void Flush()
 {
     int Character;
@@ -22,17 +75,9 @@ static void Flush()
         ;
 }
 
-void ClearScreen()
-{
-#ifdef _WIN32
-    system("cls");
-#else
-    system("clear");
-#endif
-}
-
 bool ReadInt(int& Result)
 {
+    PresentScreen();
     int ReadResult;
     int Error = scanf("%i", &ReadResult);
     Flush();
@@ -64,6 +109,7 @@ bool ReadPositiveInt(int& Result)
 
 bool ReadPositiveDouble(double& Result)
 {
+    PresentScreen();
     double ReadResult;
     int Error = scanf("%lf", &ReadResult);
     Flush();
@@ -85,6 +131,7 @@ bool ReadPositiveDouble(double& Result)
 
 bool ReadBool(bool& Result)
 {
+    PresentScreen();
     char ReadResult;
     int Error = scanf("%c", &ReadResult);
     Flush();
@@ -109,12 +156,13 @@ bool ReadBool(bool& Result)
     return true;
 }
 
-bool ReadString(std::string& Result, std::regex Pattern)
+bool ReadString(std::string& Result, const input_pattern& Pattern)
 {
+    PresentScreen();
     std::string Input;
     std::getline(std::cin, Input);
 
-    if (!std::regex_match(Input, Pattern))
+    if (!MatchPattern(Input, Pattern))
     {
         return false;
     }
@@ -12,14 +12,29 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <stdlib.h>
-#include <regex>
 #include <string>
 
-void ClearScreen();
+// Character class matcher standing in for "^([<class>]+|-1)$" regexes. The
+// class is expanded once into a lookup table, so matching is one table read
+// per character.
+struct input_pattern
+{
+    uint8_t Allowed[256];
+    bool AllowCancel; // Also accept exactly "-1"
+};
+
+// Class is written like the inside of a regex bracket, eg. "A-Za-z .,"
+input_pattern CreateInputPattern(const char* Class, bool AllowCancel);
+bool MatchPattern(const std::string& Input, const input_pattern& Pattern);
+
+extern const input_pattern NamePattern;        // Letters and spaces
+extern const input_pattern UnitPattern;        // Letters and spaces
+extern const input_pattern DescriptionPattern; // Letters, spaces and .,
 
 bool ReadInt(int& Result);
 bool ReadPositiveDouble(double& Result);
 bool ReadPositiveInt(int& Result);
 bool ReadBool(bool& Result);
-bool ReadString(std::string& Result, std::regex Pattern);
+bool ReadString(std::string& Result, const input_pattern& Pattern);
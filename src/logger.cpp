@@ -11,10 +11,17 @@
  */
 
 #include "logger.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string>
+#include <thread>
+#include <time.h>
 
 static const char* LogLevelToString(log_level LogLevel)
 {
@@ -29,112 +36,305 @@ static const char* LogLevelToString(log_level LogLevel)
 }
 
 logger S_Logger;
+// Threads on reader connections log too, the ring is written under this
+static std::mutex S_LoggerLock;
 
-void LoggerInit(logger Logger)
+// Slot of the bounded multi-producer queue feeding the file writer. Sequence
+// tells producers and the writer whose turn it is to use the slot.
+struct log_record
 {
-    S_Logger = Logger;
+    std::atomic<size_t> Sequence;
+    int64_t Timestamp; // Milliseconds since the epoch
+    char Message[BB_LOG_MESSAGE_LENGTH];
+};
+
+static log_record* S_LogQueue;
+static std::atomic<size_t> S_LogQueueHead;
+static size_t S_LogQueueTail; // Only touched by the writer thread
+static std::atomic<unsigned long> S_LogQueueDropped;
+
+static std::atomic<bool> S_LogFileRunning;
+static std::thread S_LogFileWriter;
+static std::string S_LogFilePath;
+static FILE* S_LogFile;
+static long S_LogFileSize;
+
+static int64_t NowMilliseconds()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
 }
 
-logger CreateLogger(const char* Name, unsigned int Messages)
+static void PushLogRecord(const char* Message)
 {
-    logger Logger = {};
-    Logger.Messages = (char**)malloc(sizeof(char*) * Messages);
-    Logger.Name = Name;
+    size_t Position = S_LogQueueHead.load(std::memory_order_relaxed);
+    log_record* Record;
+    while (true)
+    {
+        Record = &S_LogQueue[Position & (BB_LOG_QUEUE_CAPACITY - 1)];
+        size_t Sequence = Record->Sequence.load(std::memory_order_acquire);
+        intptr_t Difference = (intptr_t)Sequence - (intptr_t)Position;
+
+        if (Difference == 0)
+        {
+            if (S_LogQueueHead.compare_exchange_weak(
+                    Position, Position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (Difference < 0)
+        {
+            // Writer has fallen a whole queue behind, never block the caller
+            S_LogQueueDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            Position = S_LogQueueHead.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record->Timestamp = NowMilliseconds();
+    strcpy(Record->Message, Message);
+    Record->Sequence.store(Position + 1, std::memory_order_release);
+}
 
-    for (int i = 0; i < Messages; i++)
+static void RotateLogFile()
+{
+    fclose(S_LogFile);
+
+    char From[512];
+    char To[512];
+    for (int i = BB_LOG_FILE_COUNT - 1; i > 0; i--)
     {
-        Logger.Messages[i] = nullptr;
+        snprintf(From, sizeof(From), "%s.%i", S_LogFilePath.c_str(), i);
+        snprintf(To, sizeof(To), "%s.%i", S_LogFilePath.c_str(), i + 1);
+        rename(From, To);
     }
 
-    Logger.MessagesSize = Messages;
-    return Logger;
+    snprintf(To, sizeof(To), "%s.1", S_LogFilePath.c_str());
+    rename(S_LogFilePath.c_str(), To);
+
+    S_LogFile = fopen(S_LogFilePath.c_str(), "a");
+    S_LogFileSize = 0;
 }
 
-char* FormatString(log_level LogLevel, const char* Format, ...)
+static void WriteLogLine(int64_t Timestamp, const char* Message)
 {
-    va_list VArgs;
-    va_start(VArgs, Format);
+    time_t Seconds = Timestamp / 1000;
+    struct tm Local;
+    localtime_r(&Seconds, &Local);
 
-    va_list VArgsCopy;
-    va_copy(VArgsCopy, VArgs);
-    int Size = vsnprintf(NULL, 0, Format, VArgsCopy);
-    va_end(VArgsCopy);
+    char Time[32];
+    strftime(Time, sizeof(Time), "%Y-%m-%d %H:%M:%S", &Local);
 
-    if (Size < 0)
+    int Written = fprintf(S_LogFile, "%s.%03i %s\n", Time,
+                          (int)(Timestamp % 1000), Message);
+    if (Written > 0)
     {
-        va_end(VArgs);
-        return NULL;
+        S_LogFileSize += Written;
     }
 
-    const char* Prefix = LogLevelToString(LogLevel);
-    int PrefixLength = strlen(Prefix);
+    if (S_LogFileSize >= BB_LOG_FILE_SIZE)
+    {
+        RotateLogFile();
+    }
+}
 
-    char* String = (char*)malloc(PrefixLength + 1 + Size + 1);
-    if (!String)
+static void LogFileWriterThread()
+{
+    unsigned long ReportedDropped = 0;
+    while (S_LogFile != nullptr)
     {
-        va_end(VArgs);
-        return NULL;
+        int Written = 0;
+        while (S_LogFile != nullptr)
+        {
+            log_record* Record =
+                &S_LogQueue[S_LogQueueTail & (BB_LOG_QUEUE_CAPACITY - 1)];
+            if (Record->Sequence.load(std::memory_order_acquire) !=
+                S_LogQueueTail + 1)
+            {
+                break; // Queue is empty
+            }
+
+            WriteLogLine(Record->Timestamp, Record->Message);
+            Record->Sequence.store(S_LogQueueTail + BB_LOG_QUEUE_CAPACITY,
+                                   std::memory_order_release);
+            S_LogQueueTail++;
+            Written++;
+        }
+
+        unsigned long Dropped =
+            S_LogQueueDropped.load(std::memory_order_relaxed);
+        if (Dropped != ReportedDropped && S_LogFile != nullptr)
+        {
+            char Message[64];
+            snprintf(Message, sizeof(Message),
+                     "[WARN]: %lu log messages dropped",
+                     Dropped - ReportedDropped);
+            WriteLogLine(NowMilliseconds(), Message);
+            ReportedDropped = Dropped;
+            Written++;
+        }
+
+        if (Written > 0 && S_LogFile != nullptr)
+        {
+            fflush(S_LogFile);
+        }
+        else if (!S_LogFileRunning.load(std::memory_order_acquire))
+        {
+            break; // Asked to stop and the queue is drained
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+}
+
+bool LogFileInit(const char* Path)
+{
+    if (S_LogFileRunning)
+    {
+        return false;
     }
 
-    strcpy(String, Prefix);
-    strcat(String, " ");
+    S_LogFile = fopen(Path, "a");
+    if (S_LogFile == nullptr)
+    {
+        fprintf(stderr, "Failed to open log file '%s'.\n", Path);
+        return false;
+    }
 
-    vsnprintf(String + PrefixLength + 1, Size + 1, Format, VArgs);
-    va_end(VArgs);
+    fseek(S_LogFile, 0, SEEK_END);
+    S_LogFileSize = ftell(S_LogFile);
+    S_LogFilePath = Path;
 
-    return String;
+    S_LogQueue = new log_record[BB_LOG_QUEUE_CAPACITY];
+    for (size_t i = 0; i < BB_LOG_QUEUE_CAPACITY; i++)
+    {
+        S_LogQueue[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+    S_LogQueueHead.store(0, std::memory_order_relaxed);
+    S_LogQueueTail = 0;
+    S_LogQueueDropped.store(0, std::memory_order_relaxed);
+
+    S_LogFileRunning.store(true, std::memory_order_release);
+    S_LogFileWriter = std::thread(LogFileWriterThread);
+    return true;
 }
 
-void Log(char* String)
+void LogFileClose()
 {
-    if (!S_Logger.Messages)
+    if (!S_LogFileRunning)
     {
         return;
     }
 
-    char** Messages = S_Logger.Messages;
-    char* LastMessage = Messages[S_Logger.MessagesSize - 1];
-    free(LastMessage);
+    S_LogFileRunning.store(false, std::memory_order_release);
+    S_LogFileWriter.join();
 
-    for (int i = S_Logger.MessagesSize - 1; i > 0; i--)
+    if (S_LogFile != nullptr)
     {
-        Messages[i] = Messages[i - 1];
+        fclose(S_LogFile);
+        S_LogFile = nullptr;
     }
 
-    Messages[0] = (char*)String;
+    delete[] S_LogQueue;
+    S_LogQueue = nullptr;
 }
 
-    void PrintLogs()
+void LoggerInit(logger Logger)
 {
-    printf("\t\t[%s]\n", S_Logger.Name);
-    for (int i = S_Logger.MessagesSize - 1; i >= 0; i--)
+    S_Logger = Logger;
+}
+
+logger CreateLogger(const char* Name, unsigned int Messages)
+{
+    logger Logger = {};
+    Logger.Messages = (char*)malloc(BB_LOG_MESSAGE_LENGTH * Messages);
+    Logger.Name = Name;
+    Logger.MessagesSize = Logger.Messages ? Messages : 0;
+    return Logger;
+}
+
+void Log(log_level LogLevel, const char* Format, ...)
+{
+    bool ToFile = S_LogFileRunning.load(std::memory_order_relaxed);
+    bool ToMemory = S_Logger.Messages && S_Logger.MessagesSize > 0;
+    if (!ToFile && !ToMemory)
     {
-        char* Message = S_Logger.Messages[i];
+        return;
+    }
 
-        if (Message)
-        {
-            printf("%s\n", Message);
-        }
+    char Message[BB_LOG_MESSAGE_LENGTH];
+    int PrefixLength = snprintf(Message, sizeof(Message), "%s ",
+                                LogLevelToString(LogLevel));
+
+    va_list VArgs;
+    va_start(VArgs, Format);
+    vsnprintf(Message + PrefixLength, sizeof(Message) - PrefixLength, Format,
+              VArgs);
+    va_end(VArgs);
+
+    if (ToFile)
+    {
+        PushLogRecord(Message);
+    }
+
+    if (!ToMemory)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Guard(S_LoggerLock);
+    memcpy(S_Logger.Messages + S_Logger.Head * BB_LOG_MESSAGE_LENGTH, Message,
+           sizeof(Message));
+    S_Logger.Head = (S_Logger.Head + 1) % S_Logger.MessagesSize;
+    if (S_Logger.Count < S_Logger.MessagesSize)
+    {
+        S_Logger.Count++;
+    }
+}
+
+void PrintLogs()
+{
+    printf("\t\t[%s]\n", S_Logger.Name);
+
+    for (unsigned int i = 0; i < S_Logger.Count; i++)
+    {
+        printf("%s\n", GetLogMessage(i));
     }
     printf("\n");
 }
 
+const char* GetLogMessage(unsigned int Index)
+{
+    if (Index >= S_Logger.Count)
+    {
+        return nullptr;
+    }
+
+    // Oldest first. Until the buffer wraps the oldest message is in slot 0,
+    // after that it is the one Head is about to overwrite.
+    unsigned int Oldest =
+        S_Logger.Count < S_Logger.MessagesSize ? 0 : S_Logger.Head;
+    unsigned int Slot = (Oldest + Index) % S_Logger.MessagesSize;
+    return S_Logger.Messages + Slot * BB_LOG_MESSAGE_LENGTH;
+}
+
 void FreeLogger()
 {
-    ClearLogs();
+    LogFileClose();
     free(S_Logger.Messages);
     S_Logger = {};
 }
 
 void ClearLogs()
 {
-    char** Messages = S_Logger.Messages;
-    if (Messages)
-    {
-        for (int i = 0; i < S_Logger.MessagesSize; i++)
-        {
-            free(Messages[i]);
-            Messages[i] = nullptr;
-        }
-    }
+    std::lock_guard<std::mutex> Guard(S_LoggerLock);
+    S_Logger.Head = 0;
+    S_Logger.Count = 0;
 }
@@ -13,19 +13,27 @@
 #pragma once
 
 #define BB_LOG_INFO(Format, ...)                                           \
-    Log(FormatString(log_level::log_info, Format, ##__VA_ARGS__))
+    Log(log_level::log_info, Format, ##__VA_ARGS__)
 #define BB_LOG_WARN(Format, ...)                                           \
-    Log(FormatString(log_level::log_warning, Format, ##__VA_ARGS__))
+    Log(log_level::log_warning, Format, ##__VA_ARGS__)
 #define BB_LOG_ERROR(Format, ...)                                          \
-    Log(FormatString(log_level::log_error, Format, ##__VA_ARGS__))
+    Log(log_level::log_error, Format, ##__VA_ARGS__)
 
 #ifdef BB_DEBUG_BUILD
     #define BB_LOG_DEBUG(Format, ...)                                          \
-        Log(FormatString(log_level::log_debug, Format, ##__VA_ARGS__))
+        Log(log_level::log_debug, Format, ##__VA_ARGS__)
 #else
     #define BB_LOG_DEBUG(Format, ...)
 #endif
 
+// Longer messages are truncated
+#define BB_LOG_MESSAGE_LENGTH 256
+
+// File sink, queued messages beyond the capacity are dropped and counted
+#define BB_LOG_QUEUE_CAPACITY 1024 // Must be a power of two
+#define BB_LOG_FILE_SIZE (1 << 20)
+#define BB_LOG_FILE_COUNT 5
+
 enum class log_level
 {
     log_error,
@@ -34,11 +42,15 @@ enum class log_level
     log_debug
 };
 
+// Ring buffer of MessagesSize fixed-size slots allocated up front. Head is the
+// slot the next message is written to, logging never allocates or shifts.
 struct logger
 {
     const char* Name;
-    char** Messages;
+    char* Messages;
     unsigned int MessagesSize;
+    unsigned int Head;
+    unsigned int Count;
 };
 
 extern logger S_Logger;
@@ -49,6 +61,19 @@ void LoggerInit(logger Logger);
 logger CreateLogger(const char* Name, unsigned int Messages);
 void FreeLogger();
 void ClearLogs();
-void Log(char* String);
+void Log(log_level LogLevel, const char* Format, ...);
 void PrintLogs();
-char* FormatString(log_level LogLevel, const char* Format, ...);
+
+// Log() and ClearLogs() may be called from any thread. PrintLogs() and
+// GetLogMessage() read the ring unguarded, for the thread that owns the UI
+// or the service's writer.
+// Index 0 is the oldest message held, nullptr past the newest. The pointer is
+// only good until the next Log() or ClearLogs().
+const char* GetLogMessage(unsigned int Index);
+
+// Optional persistent sink. Log() only pushes onto a lock-free queue, a
+// background thread timestamps the messages and writes them to Path in
+// batches, rotating it to Path.1 .. Path.BB_LOG_FILE_COUNT as it fills up.
+// FreeLogger() drains the queue and stops the thread.
+bool LogFileInit(const char* Path);
+void LogFileClose();
@@ -0,0 +1,265 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: migrations.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Evolve the schema of an existing database in place
+ */
+
+#include "migrations.hpp"
+#include "database.hpp"
+#include <stdio.h>
+
+struct migration
+{
+    int Version;
+    const char* Description;
+    const char* Script;
+};
+
+// Append only. A migration that has shipped must never be edited, add a new
+// one with the next version instead.
+static const migration Migrations[] = {
+    {1, "Covering indexes for item, supply and order date lookups", R"(
+        CREATE INDEX IF NOT EXISTS MenuOrderItemByItem
+            ON MenuOrderItem(ItemID, OrderNumber, OrderQuantity);
+
+        CREATE INDEX IF NOT EXISTS IngredientBySupply
+            ON Ingredient(SupplyID, ItemID, Quantity);
+
+        CREATE INDEX IF NOT EXISTS MenuOrderByDate
+            ON MenuOrder(OrderDate);
+    )"},
+    {2, "Daily sales aggregates for reports", R"(
+        CREATE TABLE DailyItemSales (
+            SaleDate   TEXT    NOT NULL,
+            ItemID     INTEGER NOT NULL,
+            Quantity   INTEGER NOT NULL,
+            Revenue    FLOAT   NOT NULL,
+            OrderCount INTEGER NOT NULL,
+
+            PRIMARY KEY(SaleDate, ItemID)
+        ) WITHOUT ROWID;
+
+        CREATE TABLE DailyOrders (
+            SaleDate   TEXT    NOT NULL PRIMARY KEY,
+            OrderCount INTEGER NOT NULL
+        ) WITHOUT ROWID;
+
+        INSERT INTO DailyItemSales
+        SELECT
+        MenuOrder.OrderDate,
+        MenuOrderItem.ItemID,
+        sum(MenuOrderItem.OrderQuantity),
+        sum(MenuOrderItem.OrderQuantity * coalesce(Item.ItemPrice, 0)),
+        count(*)
+        FROM MenuOrderItem
+        JOIN MenuOrder ON MenuOrder.OrderNumber = MenuOrderItem.OrderNumber
+        LEFT JOIN Item ON Item.ItemID = MenuOrderItem.ItemID
+        GROUP BY MenuOrder.OrderDate, MenuOrderItem.ItemID;
+
+        INSERT INTO DailyOrders
+        SELECT OrderDate, count(*)
+        FROM MenuOrder
+        GROUP BY OrderDate;
+    )"},
+    {3, "Row counts kept by triggers", R"(
+        CREATE TABLE RowCounts (
+            TableName TEXT    NOT NULL PRIMARY KEY,
+            RowCount  INTEGER NOT NULL
+        ) WITHOUT ROWID;
+
+        INSERT INTO RowCounts
+        SELECT 'MenuOrder', count(*) FROM MenuOrder
+        UNION ALL SELECT 'Item', count(*) FROM Item
+        UNION ALL SELECT 'SupplyItem', count(*) FROM SupplyItem;
+
+        CREATE TRIGGER MenuOrderCountInsert AFTER INSERT ON MenuOrder
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount + 1
+            WHERE TableName = 'MenuOrder';
+        END;
+
+        CREATE TRIGGER MenuOrderCountDelete AFTER DELETE ON MenuOrder
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount - 1
+            WHERE TableName = 'MenuOrder';
+        END;
+
+        CREATE TRIGGER ItemCountInsert AFTER INSERT ON Item
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount + 1
+            WHERE TableName = 'Item';
+        END;
+
+        CREATE TRIGGER ItemCountDelete AFTER DELETE ON Item
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount - 1
+            WHERE TableName = 'Item';
+        END;
+
+        CREATE TRIGGER SupplyItemCountInsert AFTER INSERT ON SupplyItem
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount + 1
+            WHERE TableName = 'SupplyItem';
+        END;
+
+        CREATE TRIGGER SupplyItemCountDelete AFTER DELETE ON SupplyItem
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount - 1
+            WHERE TableName = 'SupplyItem';
+        END;
+    )"},
+    {4, "Order lines keep the price they were sold at", R"(
+        ALTER TABLE MenuOrderItem ADD COLUMN UnitPrice FLOAT;
+
+        UPDATE MenuOrderItem
+        SET UnitPrice = (SELECT ItemPrice FROM Item
+                         WHERE Item.ItemID = MenuOrderItem.ItemID);
+    )"},
+    // Without AUTOINCREMENT numbering restarts below archived orders once the
+    // newest ones have been moved out. Dropping MenuOrder takes its index and
+    // triggers with it, so they are created again.
+    {5, "Order numbers are never reused", R"(
+        CREATE TABLE MenuOrderRebuilt (
+            OrderNumber INTEGER  NOT NULL PRIMARY KEY AUTOINCREMENT,
+            OrderDate   TEXT     NOT NULL
+        );
+
+        INSERT INTO MenuOrderRebuilt (OrderNumber, OrderDate)
+        SELECT OrderNumber, OrderDate FROM MenuOrder;
+
+        DROP TABLE MenuOrder;
+        ALTER TABLE MenuOrderRebuilt RENAME TO MenuOrder;
+
+        CREATE INDEX MenuOrderByDate ON MenuOrder(OrderDate);
+
+        CREATE TRIGGER MenuOrderCountInsert AFTER INSERT ON MenuOrder
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount + 1
+            WHERE TableName = 'MenuOrder';
+        END;
+
+        CREATE TRIGGER MenuOrderCountDelete AFTER DELETE ON MenuOrder
+        BEGIN
+            UPDATE RowCounts SET RowCount = RowCount - 1
+            WHERE TableName = 'MenuOrder';
+        END;
+    )"},
+    // Orders deduct SupplyItem.StockQuantity, which the catalogue doesn't
+    // hold, so only name and unit changes to a supply count
+    {6, "Catalogue version for registers to notice menu changes", R"(
+        CREATE TABLE CatalogVersion (
+            Version INTEGER NOT NULL
+        );
+
+        INSERT INTO CatalogVersion VALUES (0);
+
+        CREATE TRIGGER ItemCatalogInsert AFTER INSERT ON Item
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER ItemCatalogUpdate AFTER UPDATE ON Item
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER ItemCatalogDelete AFTER DELETE ON Item
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER IngredientCatalogInsert AFTER INSERT ON Ingredient
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER IngredientCatalogUpdate AFTER UPDATE ON Ingredient
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER IngredientCatalogDelete AFTER DELETE ON Ingredient
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER SupplyItemCatalogInsert AFTER INSERT ON SupplyItem
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER SupplyItemCatalogUpdate
+            AFTER UPDATE OF SupplyName, UnitName ON SupplyItem
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+
+        CREATE TRIGGER SupplyItemCatalogDelete AFTER DELETE ON SupplyItem
+        BEGIN
+            UPDATE CatalogVersion SET Version = Version + 1;
+        END;
+    )"},
+};
+
+int GetSchemaVersion()
+{
+    int Result = 0;
+    statement Statement = AcquireStatement("PRAGMA user_version;");
+    if (Statement != nullptr && StepRow(Statement))
+    {
+        Result = row_reader(Statement).integer();
+    }
+
+    return Result;
+}
+
+static bool _Exec(const char* Query)
+{
+    char* Error = nullptr;
+    if (sqlite3_exec(DatabaseHandle(), Query, nullptr, nullptr, &Error) !=
+        SQLITE_OK)
+    {
+        fprintf(stderr, "%s\n", Error);
+        sqlite3_free(Error);
+        return false;
+    }
+
+    return true;
+}
+
+bool RunMigrations()
+{
+    int Version = GetSchemaVersion();
+    for (const migration& Migration : Migrations)
+    {
+        if (Migration.Version <= Version)
+        {
+            continue;
+        }
+
+        char SetVersion[64];
+        snprintf(SetVersion, sizeof(SetVersion), "PRAGMA user_version = %i;",
+                 Migration.Version);
+
+        bool Result = _Exec("BEGIN IMMEDIATE;") && _Exec(Migration.Script) &&
+                      _Exec(SetVersion) && _Exec("COMMIT;");
+
+        if (!Result)
+        {
+            _Exec("ROLLBACK;");
+            fprintf(stderr, "Failed to migrate database to version %i (%s).\n",
+                    Migration.Version, Migration.Description);
+            return false;
+        }
+
+        Version = Migration.Version;
+    }
+
+    return true;
+}
@@ -0,0 +1,20 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: migrations.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Evolve the schema of an existing database in place
+ */
+
+#pragma once
+
+// Schema version tracked through PRAGMA user_version
+int GetSchemaVersion();
+
+// Apply every migration newer than the current schema version, each in its
+// own transaction. Called from DatabaseInit() before any other query.
+bool RunMigrations();
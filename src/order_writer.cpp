@@ -0,0 +1,231 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: order_writer.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Group commit of concurrent orders on a single writer thread
+ */
+
+#include "order_writer.hpp"
+#include "logger.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// An order to batch, or a job when Work is set
+struct writer_job
+{
+    std::vector<order_input> Items;
+    std::promise<order_receipt> Receipt;
+    std::chrono::steady_clock::time_point Queued;
+    std::function<void()> Work;
+};
+
+static std::mutex S_WriterLock;
+static std::condition_variable S_WriterWake;
+static std::deque<writer_job> S_WriterQueue;
+static bool S_WriterStopping;
+static bool S_WriterRunning;
+static std::thread S_WriterThread;
+static order_writer_options S_WriterOptions;
+
+// Orders at the front of the queue, counting no further than MaxBatch
+static size_t _LeadingOrders()
+{
+    size_t Count = 0;
+    while (Count < S_WriterQueue.size() &&
+           Count < (size_t)S_WriterOptions.MaxBatch &&
+           !S_WriterQueue[Count].Work)
+    {
+        Count++;
+    }
+    return Count;
+}
+
+static void _CommitOrders(std::vector<writer_job>& Batch)
+{
+    std::vector<order_receipt> Receipts(Batch.size());
+
+    Transaction();
+    for (size_t i = 0; i < Batch.size(); i++)
+    {
+        order_receipt& Receipt = Receipts[i];
+        Receipt.OrderNumber = 0;
+
+        ClearLogs();
+        Receipt.Ok = CreateOrder(Batch[i].Items, &Receipt.OrderNumber);
+        for (unsigned int m = 0; GetLogMessage(m) != nullptr; m++)
+        {
+            Receipt.Messages.push_back(GetLogMessage(m));
+        }
+    }
+    Commit();
+
+    // A failed RELEASE leaves the transaction open, nothing in it was kept
+    if (!sqlite3_get_autocommit(DatabaseHandle()))
+    {
+        Rollback();
+
+        ClearLogs();
+        BB_LOG_ERROR("Failed to commit a batch of %zu orders. (%s)",
+                     Batch.size(), sqlite3_errmsg(DatabaseHandle()));
+        for (order_receipt& Receipt : Receipts)
+        {
+            if (Receipt.Ok)
+            {
+                Receipt.Ok = false;
+                Receipt.OrderNumber = 0;
+                Receipt.Messages.push_back(GetLogMessage(0));
+            }
+        }
+    }
+
+    BB_LOG_DEBUG("Committed %zu orders in one transaction.", Batch.size());
+    for (size_t i = 0; i < Batch.size(); i++)
+    {
+        Batch[i].Receipt.set_value(std::move(Receipts[i]));
+    }
+}
+
+static void _WriterThread()
+{
+    std::unique_lock<std::mutex> Lock(S_WriterLock);
+    while (true)
+    {
+        S_WriterWake.wait(
+            Lock, [] { return S_WriterStopping || !S_WriterQueue.empty(); });
+        if (S_WriterQueue.empty())
+        {
+            break;
+        }
+
+        if (S_WriterQueue.front().Work)
+        {
+            std::function<void()> Work = std::move(S_WriterQueue.front().Work);
+            S_WriterQueue.pop_front();
+
+            Lock.unlock();
+            Work();
+        }
+        else
+        {
+            // Hold the batch open for later orders, unless it is full, a job
+            // is waiting behind it or the writer is stopping
+            std::chrono::steady_clock::time_point Deadline =
+                S_WriterQueue.front().Queued +
+                std::chrono::microseconds(S_WriterOptions.WindowMicroseconds);
+            S_WriterWake.wait_until(Lock, Deadline, [] {
+                size_t Orders = _LeadingOrders();
+                return S_WriterStopping ||
+                       Orders >= (size_t)S_WriterOptions.MaxBatch ||
+                       Orders < S_WriterQueue.size();
+            });
+
+            std::vector<writer_job> Batch;
+            for (size_t Orders = _LeadingOrders(); Orders > 0; Orders--)
+            {
+                Batch.push_back(std::move(S_WriterQueue.front()));
+                S_WriterQueue.pop_front();
+            }
+
+            Lock.unlock();
+            _CommitOrders(Batch);
+        }
+
+        if (S_WriterOptions.Completed)
+        {
+            S_WriterOptions.Completed();
+        }
+        Lock.lock();
+    }
+}
+
+bool StartOrderWriter(const order_writer_options& Options)
+{
+    if (S_WriterRunning)
+    {
+        BB_LOG_ERROR("The order writer is already running.");
+        return false;
+    }
+
+    if (Options.WindowMicroseconds < 0 || Options.MaxBatch <= 0)
+    {
+        BB_LOG_ERROR("Invalid group commit window %i us or batch size %i.",
+                     Options.WindowMicroseconds, Options.MaxBatch);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Guard(S_WriterLock);
+    S_WriterOptions = Options;
+    S_WriterStopping = false;
+    S_WriterRunning = true;
+    S_WriterThread = std::thread(_WriterThread);
+    return true;
+}
+
+void StopOrderWriter()
+{
+    if (!S_WriterRunning)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(S_WriterLock);
+        S_WriterStopping = true;
+    }
+    S_WriterWake.notify_one();
+    S_WriterThread.join();
+
+    std::lock_guard<std::mutex> Guard(S_WriterLock);
+    S_WriterRunning = false;
+    S_WriterOptions = {};
+}
+
+std::future<order_receipt> SubmitOrder(std::vector<order_input> Items)
+{
+    writer_job Job;
+    Job.Items = std::move(Items);
+    Job.Queued = std::chrono::steady_clock::now();
+    std::future<order_receipt> Receipt = Job.Receipt.get_future();
+
+    std::unique_lock<std::mutex> Lock(S_WriterLock);
+    if (!S_WriterRunning)
+    {
+        Lock.unlock();
+        std::vector<writer_job> Batch(1);
+        Batch[0] = std::move(Job);
+        _CommitOrders(Batch);
+        return Receipt;
+    }
+
+    S_WriterQueue.push_back(std::move(Job));
+    Lock.unlock();
+    S_WriterWake.notify_one();
+    return Receipt;
+}
+
+void RunOnWriter(std::function<void()> Work)
+{
+    writer_job Job;
+    Job.Work = std::move(Work);
+    Job.Queued = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> Lock(S_WriterLock);
+    if (!S_WriterRunning)
+    {
+        Lock.unlock();
+        Job.Work();
+        return;
+    }
+
+    S_WriterQueue.push_back(std::move(Job));
+    Lock.unlock();
+    S_WriterWake.notify_one();
+}
@@ -0,0 +1,56 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: order_writer.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Group commit of concurrent orders on a single writer thread
+ */
+
+#pragma once
+
+#include "database.hpp"
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+/*
+ * Orders that arrive close together share one transaction. The writer thread
+ * holds the first order queued for up to WindowMicroseconds, or until
+ * MaxBatch are waiting, then creates them all inside one Transaction() and
+ * commits once. CreateOrder() runs each order in its own savepoint, so an
+ * order that fails rolls back alone and the rest of the batch still commits.
+ *
+ * While the writer runs it is the only thread that may use the writer
+ * connection or read the logger's messages. Other work goes through
+ * RunOnWriter() and runs between batches, in the order it was queued.
+ */
+
+struct order_writer_options
+{
+    int WindowMicroseconds;
+    int MaxBatch;
+    // Called on the writer thread after each batch or job has completed
+    std::function<void()> Completed;
+};
+
+struct order_receipt
+{
+    bool Ok;
+    int64_t OrderNumber;
+    // What was logged while creating the order, level prefix included
+    std::vector<std::string> Messages;
+};
+
+bool StartOrderWriter(const order_writer_options& Options);
+// Finishes everything already queued before returning
+void StopOrderWriter();
+
+// Without a running writer both run straight away on the calling thread, an
+// order in a transaction of its own
+std::future<order_receipt> SubmitOrder(std::vector<order_input> Items);
+void RunOnWriter(std::function<void()> Work);
@@ -0,0 +1,309 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: query_stats.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Per-query latency statistics collected from SQLite's trace hooks
+ */
+
+#include "query_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctype.h>
+#include <mutex>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Four buckets per power of two nanoseconds, enough for runs of ~78 hours
+#define BB_LATENCY_OCTAVES 48
+#define BB_LATENCY_BUCKETS (BB_LATENCY_OCTAVES * 4)
+
+struct query_stats
+{
+    std::string Sql;
+    uint64_t Runs;
+    uint64_t TotalNs;
+    uint64_t MaxNs;
+    uint64_t Rows;
+    uint64_t VmSteps;
+    uint32_t Latency[BB_LATENCY_BUCKETS];
+};
+
+// A statement's run in progress, from its start event to its profile event
+struct traced_run
+{
+    query_stats* Stats;
+    uint64_t Rows;
+    std::chrono::steady_clock::time_point Start;
+};
+
+// Keyed by normalized SQL. Elements of an unordered_map stay put when it
+// grows, so the other maps point straight at their entry.
+static std::unordered_map<std::string, query_stats> S_QueryStats;
+// Raw SQL to its entry, so each text is only normalized once
+static std::unordered_map<std::string, query_stats*> S_QueriesBySql;
+// SQLite reports a profile event whenever a run ends, by reset or finalize,
+// so this only ever holds statements that are running. A finalized
+// statement's address being reused can't pick up a stale run.
+static std::unordered_map<sqlite3_stmt*, traced_run> S_Running;
+// Reader connections trace from their own threads
+static std::mutex S_QueryStatsLock;
+static std::atomic<bool> S_QueryStatsEnabled;
+
+// Collapses whitespace and swaps string and number literals for '?'.
+// Parameter numbers (?1) and digits inside names are kept.
+static std::string _NormalizeSql(const char* Sql)
+{
+    std::string Result;
+    bool Space = false;
+    for (const char* Cursor = Sql; *Cursor != '\0'; Cursor++)
+    {
+        char Character = *Cursor;
+        if (isspace((unsigned char)Character))
+        {
+            Space = !Result.empty();
+            continue;
+        }
+
+        if (Space)
+        {
+            Result += ' ';
+            Space = false;
+        }
+
+        char Previous = Result.empty() ? ' ' : Result.back();
+        bool InName = isalnum((unsigned char)Previous) || Previous == '_' ||
+                      Previous == '?' || Previous == '$' || Previous == ':' ||
+                      Previous == '@';
+
+        if (Character == '\'')
+        {
+            // Skip to the closing quote, '' is a quote inside the literal
+            Cursor++;
+            while (*Cursor != '\0' && !(*Cursor == '\'' && Cursor[1] != '\''))
+            {
+                Cursor += *Cursor == '\'' ? 2 : 1;
+            }
+            Result += '?';
+            if (*Cursor == '\0')
+            {
+                break;
+            }
+        }
+        else if (isdigit((unsigned char)Character) && !InName)
+        {
+            while (isalnum((unsigned char)Cursor[1]) || Cursor[1] == '.')
+            {
+                Cursor++;
+            }
+            Result += '?';
+        }
+        else
+        {
+            Result += Character;
+        }
+    }
+
+    while (!Result.empty() && Result.back() == ';')
+    {
+        Result.pop_back();
+    }
+
+    return Result;
+}
+
+static int _LatencyBucket(uint64_t Ns)
+{
+    if (Ns < 4)
+    {
+        return (int)Ns;
+    }
+
+    int Octave = 2;
+    while ((Ns >> (Octave + 1)) != 0)
+    {
+        Octave++;
+    }
+
+    int Bucket = Octave * 4 + (int)((Ns >> (Octave - 2)) & 3);
+    return std::min(Bucket, BB_LATENCY_BUCKETS - 1);
+}
+
+// Largest latency that lands in Bucket
+static uint64_t _BucketLimit(int Bucket)
+{
+    int Octave = Bucket / 4;
+    if (Octave < 2)
+    {
+        return (uint64_t)Bucket;
+    }
+
+    return ((uint64_t)(5 + Bucket % 4) << (Octave - 2)) - 1;
+}
+
+static uint64_t _Percentile(const query_stats& Stats, double Fraction)
+{
+    uint64_t Target = (uint64_t)(Fraction * Stats.Runs + 0.999999);
+    uint64_t Seen = 0;
+    for (int Bucket = 0; Bucket < BB_LATENCY_BUCKETS; Bucket++)
+    {
+        Seen += Stats.Latency[Bucket];
+        if (Seen >= Target && Seen > 0)
+        {
+            return std::min(_BucketLimit(Bucket), Stats.MaxNs);
+        }
+    }
+
+    return Stats.MaxNs;
+}
+
+static query_stats* _Stats(sqlite3_stmt* Statement)
+{
+    const char* Sql = sqlite3_sql(Statement);
+    query_stats*& Stats = S_QueriesBySql[Sql ? Sql : ""];
+    if (Stats == nullptr)
+    {
+        std::string Normalized = _NormalizeSql(Sql ? Sql : "");
+        Stats = &S_QueryStats[Normalized];
+        if (Stats->Sql.empty())
+        {
+            Stats->Sql = Normalized;
+        }
+    }
+
+    return Stats;
+}
+
+// SQLITE_TRACE_STMT fires as a run starts, SQLITE_TRACE_ROW for each row
+// and SQLITE_TRACE_PROFILE once the run finishes. The profile event's own
+// time comes from the VFS clock, which only counts milliseconds, so runs are
+// timed from the start event instead.
+static int _TraceCallback(unsigned Event, void*, void* P, void* X)
+{
+    std::chrono::steady_clock::time_point Now =
+        std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> Guard(S_QueryStatsLock);
+    sqlite3_stmt* Statement = static_cast<sqlite3_stmt*>(P);
+
+    if (Event == SQLITE_TRACE_STMT)
+    {
+        // Triggers report here too with a "--" comment as X, while the
+        // statement that fired them is still running
+        const char* Text = static_cast<const char*>(X);
+        if (Text == nullptr || strncmp(Text, "--", 2) != 0)
+        {
+            S_Running[Statement] = {_Stats(Statement), 0, Now};
+        }
+        return 0;
+    }
+
+    auto Run = S_Running.find(Statement);
+    if (Event == SQLITE_TRACE_ROW)
+    {
+        if (Run != S_Running.end())
+        {
+            Run->second.Rows++;
+        }
+        return 0;
+    }
+
+    // A run already going when tracing started has no start event
+    uint64_t Ns = (uint64_t)*static_cast<sqlite3_int64*>(X);
+    uint64_t Rows = 0;
+    query_stats* Stats;
+    if (Run != S_Running.end())
+    {
+        Ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 Now - Run->second.Start)
+                 .count();
+        Rows = Run->second.Rows;
+        Stats = Run->second.Stats;
+        S_Running.erase(Run);
+    }
+    else
+    {
+        Stats = _Stats(Statement);
+    }
+
+    Stats->Runs++;
+    Stats->TotalNs += Ns;
+    Stats->MaxNs = std::max(Stats->MaxNs, Ns);
+    Stats->Rows += Rows;
+    Stats->VmSteps +=
+        sqlite3_stmt_status(Statement, SQLITE_STMTSTATUS_VM_STEP, 1);
+    Stats->Latency[_LatencyBucket(Ns)]++;
+    return 0;
+}
+
+void EnableQueryStats()
+{
+    S_QueryStatsEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool QueryStatsEnabled()
+{
+    return S_QueryStatsEnabled.load(std::memory_order_relaxed);
+}
+
+void QueryStatsInit(sqlite3* Connection)
+{
+    unsigned Events =
+        SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE;
+    sqlite3_trace_v2(Connection, Events, _TraceCallback, nullptr);
+}
+
+void ResetQueryStats()
+{
+    std::lock_guard<std::mutex> Guard(S_QueryStatsLock);
+    S_Running.clear();
+    S_QueriesBySql.clear();
+    S_QueryStats.clear();
+}
+
+void PrintQueryStats(FILE* Stream)
+{
+    std::lock_guard<std::mutex> Guard(S_QueryStatsLock);
+    std::vector<const query_stats*> Sorted;
+    uint64_t Runs = 0;
+    for (const auto& Entry : S_QueryStats)
+    {
+        // A statement still on its first run has no entry worth showing yet
+        if (Entry.second.Runs > 0)
+        {
+            Sorted.push_back(&Entry.second);
+            Runs += Entry.second.Runs;
+        }
+    }
+
+    std::sort(Sorted.begin(), Sorted.end(),
+              [](const query_stats* A, const query_stats* B) {
+                  return A->TotalNs > B->TotalNs;
+              });
+
+    fprintf(Stream, "Query stats, %zu queries over %llu runs\n",
+            Sorted.size(), (unsigned long long)Runs);
+    fprintf(Stream, "%8s %10s %9s %9s %9s %9s %9s %9s\n", "Runs", "Total ms",
+            "p50 us", "p95 us", "p99 us", "Max us", "Rows/run", "Steps/run");
+
+    for (const query_stats* Stats : Sorted)
+    {
+        fprintf(Stream,
+                "%8llu %10.2lf %9.1lf %9.1lf %9.1lf %9.1lf %9.1lf %9.1lf\n",
+                (unsigned long long)Stats->Runs, Stats->TotalNs / 1e6,
+                _Percentile(*Stats, 0.50) / 1e3,
+                _Percentile(*Stats, 0.95) / 1e3,
+                _Percentile(*Stats, 0.99) / 1e3, Stats->MaxNs / 1e3,
+                (double)Stats->Rows / Stats->Runs,
+                (double)Stats->VmSteps / Stats->Runs);
+        fprintf(Stream, "         %.120s%s\n", Stats->Sql.c_str(),
+                Stats->Sql.size() > 120 ? "..." : "");
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: query_stats.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Per-query latency statistics collected from SQLite's trace hooks
+ */
+
+#pragma once
+
+#include "sqlite3.h"
+#include <stdio.h>
+
+// Tracing takes a lock and a hash lookup for every row returned, so nothing
+// is traced until this is called. Once it has been, database.cpp hooks each
+// connection the next time its thread uses it.
+void EnableQueryStats();
+bool QueryStatsEnabled();
+
+// Registers the statement, row and profile trace hooks on Connection. Every
+// statement run from then on is counted under its SQL with whitespace
+// collapsed and literals replaced by '?', so one query shows up once however
+// it is built. Runs on the writer and read-only connections are counted
+// together.
+void QueryStatsInit(sqlite3* Connection);
+void ResetQueryStats();
+
+// One block per query, the most total time first: runs, total time,
+// p50/p95/p99/max latency, and rows and VM steps per run. Percentiles come
+// from quarter-octave buckets and are upper bounds, at most 25% high.
+void PrintQueryStats(FILE* Stream);
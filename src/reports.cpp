@@ -0,0 +1,188 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: reports.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Sales reports read from the daily aggregate tables.
+ */
+
+#include "reports.hpp"
+#include "database.hpp"
+#include <stdio.h>
+
+// DailyItemSales and DailyOrders are kept current by the order functions in
+// database.cpp, so a report reads one row per day (and item) in the range
+// instead of every order line.
+
+statement GetRevenueByDay(const char* From, const char* To)
+{
+    statement Statement = AcquireStatement(R"(
+        SELECT
+        DailyOrders.SaleDate,
+        DailyOrders.OrderCount,
+        coalesce(Sales.Quantity, 0),
+        coalesce(Sales.Revenue, 0)
+        FROM DailyOrders
+        LEFT JOIN (
+            SELECT SaleDate, sum(Quantity) AS Quantity, sum(Revenue) AS Revenue
+            FROM DailyItemSales
+            WHERE SaleDate BETWEEN coalesce(?1, '') AND coalesce(?2, '9999')
+            GROUP BY SaleDate
+        ) AS Sales ON Sales.SaleDate = DailyOrders.SaleDate
+        WHERE DailyOrders.SaleDate BETWEEN coalesce(?1, '') AND
+                                           coalesce(?2, '9999')
+            AND DailyOrders.OrderCount > 0
+        ORDER BY DailyOrders.SaleDate
+    )");
+
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement).text(From).text(To);
+    }
+
+    return Statement;
+}
+
+statement GetTopItems(const char* From, const char* To, int Limit)
+{
+    statement Statement = AcquireStatement(R"(
+        SELECT
+        DailyItemSales.ItemID,
+        coalesce(Item.ItemName, '(deleted item)'),
+        sum(DailyItemSales.Quantity) AS Quantity,
+        sum(DailyItemSales.Revenue) AS Revenue,
+        sum(DailyItemSales.OrderCount)
+        FROM DailyItemSales
+        LEFT JOIN Item ON Item.ItemID = DailyItemSales.ItemID
+        WHERE DailyItemSales.SaleDate BETWEEN coalesce(?1, '') AND
+                                              coalesce(?2, '9999')
+        GROUP BY DailyItemSales.ItemID
+        HAVING Quantity > 0
+        ORDER BY Quantity DESC, Revenue DESC
+        LIMIT ?3
+    )");
+
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement).text(From).text(To).integer(Limit);
+    }
+
+    return Statement;
+}
+
+statement GetOrderSizeTotals(const char* From, const char* To)
+{
+    statement Statement = AcquireStatement(R"(
+        SELECT
+        (SELECT coalesce(sum(OrderCount), 0)
+         FROM DailyOrders
+         WHERE SaleDate BETWEEN coalesce(?1, '') AND coalesce(?2, '9999')),
+        coalesce(sum(Quantity), 0),
+        coalesce(sum(OrderCount), 0)
+        FROM DailyItemSales
+        WHERE SaleDate BETWEEN coalesce(?1, '') AND coalesce(?2, '9999')
+    )");
+
+    if (Statement != nullptr)
+    {
+        statement_binder(Statement).text(From).text(To);
+    }
+
+    return Statement;
+}
+
+static void _PrintRange(const char* Title, const char* From, const char* To)
+{
+    printf("%s, %s to %s\n", Title, From ? From : "first sale",
+           To ? To : "today");
+}
+
+bool PrintRevenueReport(const char* From, const char* To)
+{
+    reader_lease Lease;
+    statement Statement = GetRevenueByDay(From, To);
+    if (Statement == nullptr)
+    {
+        return false;
+    }
+
+    _PrintRange("Revenue per day", From, To);
+    printf("%-12s %8s %8s %12s\n", "Date", "Orders", "Items", "Revenue");
+
+    int Orders = 0, Items = 0;
+    double Revenue = 0;
+    while (StepRow(Statement))
+    {
+        row_reader Reader(Statement);
+        const char* SaleDate = Reader.text();
+        int DayOrders = Reader.integer();
+        int DayItems = Reader.integer();
+        double DayRevenue = Reader.decimal();
+
+        printf("%-12s %8i %8i %12.2lf\n", SaleDate, DayOrders, DayItems,
+               DayRevenue);
+        Orders += DayOrders;
+        Items += DayItems;
+        Revenue += DayRevenue;
+    }
+    printf("%-12s %8i %8i %12.2lf\n\n", "Total", Orders, Items, Revenue);
+
+    return true;
+}
+
+bool PrintTopItemsReport(const char* From, const char* To, int Limit)
+{
+    reader_lease Lease;
+    statement Statement = GetTopItems(From, To, Limit);
+    if (Statement == nullptr)
+    {
+        return false;
+    }
+
+    _PrintRange("Top items", From, To);
+    printf("%-4s %-32s %8s %8s %12s\n", "#", "Item", "Sold", "Orders",
+           "Revenue");
+
+    for (int Rank = 1; StepRow(Statement); Rank++)
+    {
+        row_reader Reader(Statement);
+        Reader.integer();
+        const char* ItemName = Reader.text();
+        int Quantity = Reader.integer();
+        double Revenue = Reader.decimal();
+        int Orders = Reader.integer();
+
+        printf("%-4i %-32.32s %8i %8i %12.2lf\n", Rank, ItemName, Quantity,
+               Orders, Revenue);
+    }
+    printf("\n");
+
+    return true;
+}
+
+bool PrintOrderSizeReport(const char* From, const char* To)
+{
+    reader_lease Lease;
+    statement Statement = GetOrderSizeTotals(From, To);
+    if (Statement == nullptr || !StepRow(Statement))
+    {
+        return false;
+    }
+
+    row_reader Reader(Statement);
+    int Orders = Reader.integer();
+    int Items = Reader.integer();
+    int Lines = Reader.integer();
+
+    _PrintRange("Items per order", From, To);
+    printf("Orders: %i\n", Orders);
+    printf("Items:  %i (%.2lf per order)\n", Items,
+           Orders ? (double)Items / Orders : 0.0);
+    printf("Lines:  %i (%.2lf per order)\n\n", Lines,
+           Orders ? (double)Lines / Orders : 0.0);
+    return true;
+}
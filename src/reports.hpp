@@ -0,0 +1,33 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: reports.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Sales reports read from the daily aggregate tables.
+ */
+
+#pragma once
+
+#include "database.hpp"
+
+// Dates are "YYYY-MM-DD" and inclusive, nullptr leaves that end of the range
+// open. Returned cursors are unstepped.
+
+// (SaleDate, Orders, Items, Revenue) for every day with sales
+statement GetRevenueByDay(const char* From, const char* To);
+
+// (ItemID, ItemName, Quantity, Revenue, Orders), best sellers first
+statement GetTopItems(const char* From, const char* To, int Limit);
+
+// One row of (Orders, Items, Lines) totals
+statement GetOrderSizeTotals(const char* From, const char* To);
+
+// The Print*() reports run on a leased read-only connection, so they don't
+// hold up the writer
+bool PrintRevenueReport(const char* From, const char* To);
+bool PrintTopItemsReport(const char* From, const char* To, int Limit);
+bool PrintOrderSizeReport(const char* From, const char* To);
@@ -0,0 +1,1102 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: service.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Serve the database writes to other registers over a Unix socket
+ */
+
+#include "service.hpp"
+#include "catalog.hpp"
+#include "logger.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <memory>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Client connection to the service, -1 while writes run locally
+static int S_ServiceSocket = -1;
+static volatile sig_atomic_t S_StopService = 0;
+// The writer thread writes a byte here whenever it finishes something
+static int S_WriterDone[2] = {-1, -1};
+
+// Builds a frame. Room for the payload size is kept at the front and filled
+// in when the frame is sent.
+struct message_writer
+{
+    message_writer();
+    message_writer(service_op Op);
+    message_writer& byte(uint8_t Value);
+    message_writer& integer(int32_t Value);
+    message_writer& integer64(int64_t Value);
+    message_writer& decimal(double Value);
+    message_writer& text(const char* Text);
+
+    std::vector<uint8_t> Bytes;
+
+        private:
+    void Append(const void* Value, size_t ValueSize);
+};
+
+// Reads a payload back in the order it was written. Running past the end or
+// into a malformed string sets Failed, every read after that returns 0.
+struct message_reader
+{
+    message_reader(const uint8_t* Data, size_t Size);
+    uint8_t byte();
+    int32_t integer();
+    int64_t integer64();
+    double decimal();
+    const char* text();
+    size_t remaining();
+
+    bool Failed;
+
+        private:
+    bool Take(void* Value, size_t ValueSize);
+    const uint8_t* Data;
+    size_t Size;
+    size_t ReadIndex;
+};
+
+// A client has at most one request in flight on the writer thread, either
+// an order waiting for its batch or any other write
+struct service_client
+{
+    int Socket;
+    bool Greeted;
+    std::vector<uint8_t> Pending; // Received bytes not yet handled
+    std::future<order_receipt> Order;
+    std::future<message_writer> Reply;
+};
+
+message_writer::message_writer()
+{
+    Bytes.reserve(64); // Most requests and replies fit
+    Bytes.resize(sizeof(uint32_t));
+}
+
+message_writer::message_writer(service_op Op) : message_writer()
+{
+    byte((uint8_t)Op);
+}
+
+void message_writer::Append(const void* Value, size_t ValueSize)
+{
+    size_t Offset = Bytes.size();
+    Bytes.resize(Offset + ValueSize);
+    memcpy(Bytes.data() + Offset, Value, ValueSize);
+}
+
+message_writer& message_writer::byte(uint8_t Value)
+{
+    Bytes.push_back(Value);
+    return *this;
+}
+
+message_writer& message_writer::integer(int32_t Value)
+{
+    Append(&Value, sizeof(Value));
+    return *this;
+}
+
+message_writer& message_writer::integer64(int64_t Value)
+{
+    Append(&Value, sizeof(Value));
+    return *this;
+}
+
+message_writer& message_writer::decimal(double Value)
+{
+    Append(&Value, sizeof(Value));
+    return *this;
+}
+
+message_writer& message_writer::text(const char* Text)
+{
+    uint16_t Length = 0;
+    if (Text != nullptr)
+    {
+        size_t TextLength = strlen(Text);
+        Length = (uint16_t)(TextLength < UINT16_MAX ? TextLength + 1
+                                                    : UINT16_MAX);
+    }
+
+    Append(&Length, sizeof(Length));
+    if (Length > 0)
+    {
+        Append(Text, Length - 1);
+        Bytes.push_back('\0');
+    }
+    return *this;
+}
+
+message_reader::message_reader(const uint8_t* Data, size_t Size)
+    : Failed(false), Data(Data), Size(Size), ReadIndex(0)
+{}
+
+bool message_reader::Take(void* Value, size_t ValueSize)
+{
+    if (Failed || Size - ReadIndex < ValueSize)
+    {
+        Failed = true;
+        memset(Value, 0, ValueSize);
+        return false;
+    }
+
+    memcpy(Value, Data + ReadIndex, ValueSize);
+    ReadIndex += ValueSize;
+    return true;
+}
+
+uint8_t message_reader::byte()
+{
+    uint8_t Value;
+    Take(&Value, sizeof(Value));
+    return Value;
+}
+
+int32_t message_reader::integer()
+{
+    int32_t Value;
+    Take(&Value, sizeof(Value));
+    return Value;
+}
+
+int64_t message_reader::integer64()
+{
+    int64_t Value;
+    Take(&Value, sizeof(Value));
+    return Value;
+}
+
+double message_reader::decimal()
+{
+    double Value;
+    Take(&Value, sizeof(Value));
+    return Value;
+}
+
+// Points into the payload, valid as long as it is
+const char* message_reader::text()
+{
+    uint16_t Length;
+    if (!Take(&Length, sizeof(Length)) || Length == 0)
+    {
+        return nullptr;
+    }
+
+    if (Size - ReadIndex < Length || Data[ReadIndex + Length - 1] != '\0')
+    {
+        Failed = true;
+        return nullptr;
+    }
+
+    const char* Text = reinterpret_cast<const char*>(Data + ReadIndex);
+    ReadIndex += Length;
+    return Text;
+}
+
+size_t message_reader::remaining()
+{
+    return Failed ? 0 : Size - ReadIndex;
+}
+
+static bool _SendAll(int Socket, const uint8_t* Data, size_t Size)
+{
+    while (Size > 0)
+    {
+        ssize_t Sent = send(Socket, Data, Size, 0);
+        if (Sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (Sent <= 0)
+        {
+            return false;
+        }
+
+        Data += Sent;
+        Size -= Sent;
+    }
+
+    return true;
+}
+
+static bool _ReceiveAll(int Socket, uint8_t* Data, size_t Size)
+{
+    while (Size > 0)
+    {
+        ssize_t Received = recv(Socket, Data, Size, 0);
+        if (Received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (Received <= 0)
+        {
+            return false;
+        }
+
+        Data += Received;
+        Size -= Received;
+    }
+
+    return true;
+}
+
+static bool _SendFrame(int Socket, message_writer& Message)
+{
+    uint32_t PayloadSize = Message.Bytes.size() - sizeof(uint32_t);
+    memcpy(Message.Bytes.data(), &PayloadSize, sizeof(PayloadSize));
+    return _SendAll(Socket, Message.Bytes.data(), Message.Bytes.size());
+}
+
+static bool _ReceiveFrame(int Socket, std::vector<uint8_t>& Payload)
+{
+    uint32_t PayloadSize;
+    if (!_ReceiveAll(Socket, reinterpret_cast<uint8_t*>(&PayloadSize),
+                     sizeof(PayloadSize)) ||
+        PayloadSize > BB_SERVICE_MAX_FRAME)
+    {
+        return false;
+    }
+
+    Payload.resize(PayloadSize);
+    return _ReceiveAll(Socket, Payload.data(), PayloadSize);
+}
+
+static bool _SetAddress(const char* SocketPath, sockaddr_un& Address)
+{
+    Address = {};
+    Address.sun_family = AF_UNIX;
+    if (strlen(SocketPath) >= sizeof(Address.sun_path))
+    {
+        BB_LOG_ERROR("Socket path '%s' is too long.", SocketPath);
+        return false;
+    }
+
+    strcpy(Address.sun_path, SocketPath);
+    return true;
+}
+
+/*
+ * Server
+ */
+
+static void _StopServiceSignal(int)
+{
+    S_StopService = 1;
+}
+
+static int _Listen(const char* SocketPath)
+{
+    sockaddr_un Address;
+    if (!_SetAddress(SocketPath, Address))
+    {
+        return -1;
+    }
+
+    int Listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (Listener < 0)
+    {
+        BB_LOG_ERROR("Failed to create a socket. (%s)", strerror(errno));
+        return -1;
+    }
+
+    sockaddr* Bound = reinterpret_cast<sockaddr*>(&Address);
+    bool Result = bind(Listener, Bound, sizeof(Address)) == 0;
+    if (!Result && errno == EADDRINUSE)
+    {
+        // Take over the socket file of a service that has exited, but never
+        // that of one still answering
+        int Probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool Live = Probe >= 0 && connect(Probe, Bound, sizeof(Address)) == 0;
+        if (Probe >= 0)
+        {
+            close(Probe);
+        }
+
+        if (Live)
+        {
+            BB_LOG_ERROR("An order service is already running on '%s'.",
+                         SocketPath);
+            close(Listener);
+            return -1;
+        }
+
+        unlink(SocketPath);
+        Result = bind(Listener, Bound, sizeof(Address)) == 0;
+    }
+
+    if (!Result || listen(Listener, 16) != 0)
+    {
+        BB_LOG_ERROR("Failed to listen on '%s'. (%s)", SocketPath,
+                     strerror(errno));
+        close(Listener);
+        return -1;
+    }
+
+    return Listener;
+}
+
+// Element counts are checked against the bytes left so a bad count can't
+// make the service allocate or loop for long
+static bool _ReadCount(message_reader& Request, size_t ElementSize,
+                       int32_t& Count)
+{
+    Count = Request.integer();
+    if (Count < 0 || (size_t)Count > Request.remaining() / ElementSize)
+    {
+        Request.Failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+static bool _ReadKeys(message_reader& Request, std::vector<int>& Keys)
+{
+    int32_t Count;
+    if (!_ReadCount(Request, sizeof(int32_t), Count))
+    {
+        return false;
+    }
+
+    Keys.resize(Count);
+    for (int& Key : Keys)
+    {
+        Key = Request.integer();
+    }
+    return !Request.Failed;
+}
+
+static bool _ReadOrder(message_reader& Request, std::vector<order_input>& Items)
+{
+    int32_t Count;
+    if (!_ReadCount(Request, 2 * sizeof(int32_t), Count))
+    {
+        return false;
+    }
+
+    Items.resize(Count);
+    for (order_input& Input : Items)
+    {
+        Input.ItemID = Request.integer();
+        Input.Quantity = Request.integer();
+    }
+    return !Request.Failed;
+}
+
+// Runs one request on the writer thread and returns whether it succeeded,
+// with Value and Counts filled in by the writes that report them. Orders go
+// through SubmitOrder() instead so they can share a commit.
+static bool _HandleRequest(service_op Op, message_reader& Request,
+                           int64_t& Value, delete_counts& Counts)
+{
+    switch (Op)
+    {
+        case service_op::op_add_item_to_order:
+        {
+            int OrderNumber = Request.integer();
+            int ItemID = Request.integer();
+            int Quantity = Request.integer();
+            return !Request.Failed &&
+                   AddItemToOrder(OrderNumber, ItemID, Quantity);
+        }
+        case service_op::op_update_order_item:
+        {
+            int OrderNumber = Request.integer();
+            int ItemID = Request.integer();
+            int Quantity = Request.integer();
+            return !Request.Failed &&
+                   UpdateOrderItem(OrderNumber, ItemID, Quantity);
+        }
+        case service_op::op_delete_order_item:
+        {
+            int OrderNumber = Request.integer();
+            int ItemID = Request.integer();
+            return !Request.Failed && DeleteOrderItem(OrderNumber, ItemID);
+        }
+        case service_op::op_delete_order:
+        {
+            int OrderNumber = Request.integer();
+            return !Request.Failed && DeleteOrder(OrderNumber, &Counts);
+        }
+        case service_op::op_delete_orders:
+        {
+            std::vector<int> OrderNumbers;
+            return _ReadKeys(Request, OrderNumbers) &&
+                   DeleteOrders(OrderNumbers, &Counts);
+        }
+        case service_op::op_delete_orders_by_date:
+        {
+            const char* From = Request.text();
+            const char* To = Request.text();
+            return !Request.Failed && DeleteOrdersByDate(From, To, &Counts);
+        }
+        case service_op::op_create_item:
+        {
+            const char* ItemName = Request.text();
+            const char* ItemDescription = Request.text();
+            double ItemPrice = Request.decimal();
+
+            int32_t Count;
+            if (!_ReadCount(Request, sizeof(int32_t) + sizeof(double), Count))
+            {
+                break;
+            }
+
+            std::vector<ingredient> Ingredients(Count);
+            for (ingredient& Ingredient : Ingredients)
+            {
+                Ingredient.SupplyID = Request.integer();
+                Ingredient.Quantity = Request.decimal();
+            }
+            return !Request.Failed &&
+                   CreateItem(ItemName, ItemDescription, ItemPrice,
+                              Ingredients, &Value);
+        }
+        case service_op::op_delete_item:
+        {
+            int ItemID = Request.integer();
+            return !Request.Failed && DeleteItem(ItemID, &Counts);
+        }
+        case service_op::op_delete_items:
+        {
+            std::vector<int> ItemIDs;
+            return _ReadKeys(Request, ItemIDs) && DeleteItems(ItemIDs, &Counts);
+        }
+        case service_op::op_update_ingredient:
+        {
+            int ItemID = Request.integer();
+            int SupplyID = Request.integer();
+            double Quantity = Request.decimal();
+            return !Request.Failed &&
+                   UpdateIngredient(ItemID, SupplyID, Quantity);
+        }
+        case service_op::op_delete_ingredient:
+        {
+            int ItemID = Request.integer();
+            int SupplyID = Request.integer();
+            return !Request.Failed && DeleteIngredient(ItemID, SupplyID);
+        }
+        case service_op::op_create_supply:
+        {
+            const char* SupplyName = Request.text();
+            const char* UnitName = Request.text();
+            int Quantity = Request.integer();
+            return !Request.Failed &&
+                   CreateSupply(SupplyName, UnitName, Quantity, &Value);
+        }
+        default: break;
+    }
+
+    BB_LOG_ERROR("Malformed order service request (op %i).", (int)Op);
+    return false;
+}
+
+static message_writer _Reply(bool Ok, int64_t Value,
+                             const delete_counts& Counts)
+{
+    message_writer Reply;
+    Reply.byte(Ok)
+        .integer64(Value)
+        .integer64(Counts.Orders)
+        .integer64(Counts.OrderItems)
+        .integer64(Counts.Items)
+        .integer64(Counts.Ingredients);
+    return Reply;
+}
+
+// The messages logged while handling a request go back with the reply, each
+// as its level and its text without the level prefix
+static void _AppendLogs(message_writer& Reply,
+                        const std::vector<std::string>& Messages)
+{
+    const struct
+    {
+        log_level Level;
+        const char* Prefix;
+    } Levels[] = {
+        {log_level::log_error, "[ERROR]: "},
+        {log_level::log_warning, "[WARN]: "},
+        {log_level::log_info, "[INFO]: "},
+        {log_level::log_debug, "[DEBUG]: "},
+    };
+
+    size_t Count = Messages.size() < UINT8_MAX ? Messages.size() : UINT8_MAX;
+    Reply.byte((uint8_t)Count);
+    for (size_t i = 0; i < Count; i++)
+    {
+        const char* Message = Messages[i].c_str();
+        log_level Level = log_level::log_info;
+        for (const auto& Known : Levels)
+        {
+            size_t PrefixLength = strlen(Known.Prefix);
+            if (strncmp(Message, Known.Prefix, PrefixLength) == 0)
+            {
+                Level = Known.Level;
+                Message += PrefixLength;
+                break;
+            }
+        }
+
+        Reply.byte((uint8_t)Level).text(Message);
+    }
+}
+
+// Only for the writer thread, the only one logging while the service runs
+static std::vector<std::string> _TakeLogs()
+{
+    std::vector<std::string> Messages;
+    for (unsigned int i = 0; GetLogMessage(i) != nullptr; i++)
+    {
+        Messages.push_back(GetLogMessage(i));
+    }
+    ClearLogs();
+    return Messages;
+}
+
+// Replies to a request refused before it reached the writer thread
+static bool _Refuse(service_client& Client, const char* Format, ...)
+{
+    char Message[BB_LOG_MESSAGE_LENGTH];
+    va_list Arguments;
+    va_start(Arguments, Format);
+    vsnprintf(Message, sizeof(Message), Format, Arguments);
+    va_end(Arguments);
+
+    message_writer Reply = _Reply(false, 0, {});
+    Reply.byte(1).byte((uint8_t)log_level::log_error).text(Message);
+    return _SendFrame(Client.Socket, Reply);
+}
+
+static void _NotifyWriterDone()
+{
+    uint8_t Byte = 0;
+    ssize_t Written = write(S_WriterDone[1], &Byte, 1);
+    (void)Written; // A full pipe already has the poll loop woken up
+}
+
+// Queues the request on the writer thread, an order to be batched with
+// others or anything else as a job of its own
+static void _Submit(service_client& Client, service_op Op,
+                    message_reader& Request, std::vector<uint8_t>& Payload)
+{
+    if (Op == service_op::op_create_order)
+    {
+        std::vector<order_input> Items;
+        if (_ReadOrder(Request, Items))
+        {
+            Client.Order = SubmitOrder(std::move(Items));
+            return;
+        }
+    }
+
+    // packaged_task can't be copied into a std::function, so it is shared
+    std::shared_ptr<std::vector<uint8_t>> Shared =
+        std::make_shared<std::vector<uint8_t>>(std::move(Payload));
+    std::shared_ptr<std::packaged_task<message_writer()>> Task =
+        std::make_shared<std::packaged_task<message_writer()>>([Shared]() {
+            message_reader Request(Shared->data(), Shared->size());
+            service_op Op = (service_op)Request.byte();
+            int64_t Value = 0;
+            delete_counts Counts = {};
+
+            ClearLogs();
+            bool Ok = _HandleRequest(Op, Request, Value, Counts);
+
+            message_writer Reply = _Reply(Ok, Value, Counts);
+            _AppendLogs(Reply, _TakeLogs());
+            return Reply;
+        });
+
+    Client.Reply = Task->get_future();
+    RunOnWriter([Task]() { (*Task)(); });
+}
+
+// Starts the client's next complete frame unless it has one in flight, so
+// each client's requests run one at a time in the order sent. False drops
+// the client.
+static bool _StartRequest(service_client& Client)
+{
+    while (!Client.Order.valid() && !Client.Reply.valid() &&
+           Client.Pending.size() >= sizeof(uint32_t))
+    {
+        uint32_t PayloadSize;
+        memcpy(&PayloadSize, Client.Pending.data(), sizeof(PayloadSize));
+        if (PayloadSize > BB_SERVICE_MAX_FRAME)
+        {
+            fprintf(stderr, "Dropped a client sending a %u byte frame.\n",
+                    PayloadSize);
+            return false;
+        }
+
+        size_t FrameSize = sizeof(PayloadSize) + PayloadSize;
+        if (Client.Pending.size() < FrameSize)
+        {
+            break;
+        }
+
+        std::vector<uint8_t> Payload(
+            Client.Pending.begin() + sizeof(PayloadSize),
+            Client.Pending.begin() + FrameSize);
+        Client.Pending.erase(Client.Pending.begin(),
+                             Client.Pending.begin() + FrameSize);
+
+        // Hello never touches the database, it is answered right here
+        message_reader Request(Payload.data(), Payload.size());
+        service_op Op = (service_op)Request.byte();
+        bool Sent = true;
+        if (Op == service_op::op_hello)
+        {
+            int Version = Request.integer();
+            Client.Greeted =
+                !Request.Failed && Version == BB_SERVICE_PROTOCOL_VERSION;
+            if (Client.Greeted)
+            {
+                message_writer Reply = _Reply(true, 0, {});
+                Reply.byte(0);
+                Sent = _SendFrame(Client.Socket, Reply);
+            }
+            else
+            {
+                Sent = _Refuse(Client, "Client protocol %i, the service "
+                                       "speaks %i.",
+                               Version, BB_SERVICE_PROTOCOL_VERSION);
+            }
+        }
+        else if (!Client.Greeted)
+        {
+            Sent = _Refuse(Client,
+                           "Order service clients must say hello first.");
+        }
+        else
+        {
+            _Submit(Client, Op, Request, Payload);
+        }
+
+        if (!Sent)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Sends the reply to the request in flight once the writer is done with it.
+// False drops the client.
+static bool _FinishRequest(service_client& Client)
+{
+    std::chrono::seconds Now(0);
+    message_writer Reply;
+    if (Client.Order.valid() &&
+        Client.Order.wait_for(Now) == std::future_status::ready)
+    {
+        order_receipt Receipt = Client.Order.get();
+        Reply = _Reply(Receipt.Ok, Receipt.OrderNumber, {});
+        _AppendLogs(Reply, Receipt.Messages);
+    }
+    else if (Client.Reply.valid() &&
+             Client.Reply.wait_for(Now) == std::future_status::ready)
+    {
+        Reply = Client.Reply.get();
+    }
+    else
+    {
+        return true;
+    }
+
+    return _SendFrame(Client.Socket, Reply) && _StartRequest(Client);
+}
+
+// Reads what the client has sent and starts its next request. False drops
+// the client.
+static bool _ServeClient(service_client& Client)
+{
+    uint8_t Buffer[64 * 1024];
+    ssize_t Received = recv(Client.Socket, Buffer, sizeof(Buffer), 0);
+    if (Received < 0 && errno == EINTR)
+    {
+        return true;
+    }
+
+    if (Received <= 0)
+    {
+        return false;
+    }
+
+    Client.Pending.insert(Client.Pending.end(), Buffer, Buffer + Received);
+    return _StartRequest(Client);
+}
+
+bool RunOrderService(const char* SocketPath,
+                     const order_writer_options& Options)
+{
+    if (pipe(S_WriterDone) != 0)
+    {
+        BB_LOG_ERROR("Failed to create a pipe. (%s)", strerror(errno));
+        return false;
+    }
+    fcntl(S_WriterDone[0], F_SETFL, O_NONBLOCK);
+    fcntl(S_WriterDone[1], F_SETFL, O_NONBLOCK);
+
+    int Listener = _Listen(SocketPath);
+    order_writer_options Writer = Options;
+    Writer.Completed = _NotifyWriterDone;
+    if (Listener < 0 || !StartOrderWriter(Writer))
+    {
+        if (Listener >= 0)
+        {
+            close(Listener);
+            unlink(SocketPath);
+        }
+        close(S_WriterDone[0]);
+        close(S_WriterDone[1]);
+        return false;
+    }
+
+    // No SA_RESTART, so a signal wakes poll() up to notice the stop
+    struct sigaction Stop = {};
+    Stop.sa_handler = _StopServiceSignal;
+    sigaction(SIGINT, &Stop, nullptr);
+    sigaction(SIGTERM, &Stop, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    fprintf(stderr,
+            "Serving orders on '%s', group commit every %i us or %i "
+            "orders.\n",
+            SocketPath, Options.WindowMicroseconds, Options.MaxBatch);
+
+    // From here on the writer thread owns the database and the logger, this
+    // one only moves bytes and reports its own trouble on stderr
+    bool Result = true;
+    std::vector<service_client> Clients;
+    std::vector<pollfd> Polls;
+    while (!S_StopService)
+    {
+        Polls.assign(1, {Listener, POLLIN, 0});
+        Polls.push_back({S_WriterDone[0], POLLIN, 0});
+        for (const service_client& Client : Clients)
+        {
+            Polls.push_back({Client.Socket, POLLIN, 0});
+        }
+
+        if (poll(Polls.data(), Polls.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            fprintf(stderr, "Order service stopped. (%s)\n", strerror(errno));
+            Result = false;
+            break;
+        }
+
+        if (Polls[1].revents & POLLIN)
+        {
+            uint8_t Drain[256];
+            while (read(S_WriterDone[0], Drain, sizeof(Drain)) > 0)
+            {
+            }
+        }
+
+        // Backwards so dropping a client keeps the rest lined up with Polls
+        for (size_t i = Clients.size(); i-- > 0;)
+        {
+            bool Keep = _FinishRequest(Clients[i]);
+            if (Keep && Polls[i + 2].revents != 0)
+            {
+                Keep = _ServeClient(Clients[i]);
+            }
+
+            if (!Keep)
+            {
+                close(Clients[i].Socket);
+                Clients.erase(Clients.begin() + i);
+            }
+        }
+
+        if (Polls[0].revents & POLLIN)
+        {
+            int Socket = accept(Listener, nullptr, nullptr);
+            if (Socket >= 0)
+            {
+                Clients.push_back({Socket, false, {}, {}, {}});
+            }
+        }
+    }
+
+    // Requests already queued still run, their clients just miss the reply
+    StopOrderWriter();
+    for (const service_client& Client : Clients)
+    {
+        close(Client.Socket);
+    }
+    close(Listener);
+    unlink(SocketPath);
+    close(S_WriterDone[0]);
+    close(S_WriterDone[1]);
+    S_WriterDone[0] = S_WriterDone[1] = -1;
+
+    fprintf(stderr, "Order service on '%s' stopped.\n", SocketPath);
+    return Result;
+}
+
+/*
+ * Client
+ */
+
+// Sends Request and waits for the reply. The service's messages are logged
+// here as if the write had run locally, and Value/Counts are only written
+// when it succeeded.
+static bool _Call(message_writer& Request, int64_t* Value = nullptr,
+                  delete_counts* Counts = nullptr)
+{
+    std::vector<uint8_t> Payload;
+    if (S_ServiceSocket < 0 || !_SendFrame(S_ServiceSocket, Request) ||
+        !_ReceiveFrame(S_ServiceSocket, Payload))
+    {
+        BB_LOG_ERROR("Lost the connection to the order service.");
+        return false;
+    }
+
+    message_reader Reply(Payload.data(), Payload.size());
+    bool Ok = Reply.byte() != 0;
+    int64_t ReplyValue = Reply.integer64();
+    delete_counts ReplyCounts = {};
+    ReplyCounts.Orders = Reply.integer64();
+    ReplyCounts.OrderItems = Reply.integer64();
+    ReplyCounts.Items = Reply.integer64();
+    ReplyCounts.Ingredients = Reply.integer64();
+
+    int Messages = Reply.byte();
+    for (int i = 0; i < Messages; i++)
+    {
+        log_level Level = (log_level)Reply.byte();
+        const char* Message = Reply.text();
+        if (Message != nullptr)
+        {
+            Log(Level, "%s", Message);
+        }
+    }
+
+    if (Reply.Failed)
+    {
+        BB_LOG_ERROR("Malformed reply from the order service.");
+        return false;
+    }
+
+    if (Ok && Value != nullptr)
+    {
+        *Value = ReplyValue;
+    }
+
+    if (Ok && Counts != nullptr)
+    {
+        *Counts = ReplyCounts;
+    }
+
+    return Ok;
+}
+
+bool ConnectOrderService(const char* SocketPath)
+{
+    sockaddr_un Address;
+    if (!_SetAddress(SocketPath, Address))
+    {
+        return false;
+    }
+
+    int Socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (Socket < 0 ||
+        connect(Socket, reinterpret_cast<sockaddr*>(&Address),
+                sizeof(Address)) != 0)
+    {
+        BB_LOG_ERROR("Failed to connect to the order service on '%s'. (%s)",
+                     SocketPath, strerror(errno));
+        if (Socket >= 0)
+        {
+            close(Socket);
+        }
+        return false;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    S_ServiceSocket = Socket;
+
+    message_writer Hello(service_op::op_hello);
+    Hello.integer(BB_SERVICE_PROTOCOL_VERSION);
+    if (!_Call(Hello))
+    {
+        DisconnectOrderService();
+        return false;
+    }
+
+    return true;
+}
+
+void DisconnectOrderService()
+{
+    if (S_ServiceSocket >= 0)
+    {
+        close(S_ServiceSocket);
+        S_ServiceSocket = -1;
+    }
+}
+
+bool OrderServiceConnected()
+{
+    return S_ServiceSocket >= 0;
+}
+
+bool RemoteCreateOrder(const std::vector<order_input>& Items,
+                       int64_t* OrderNumber)
+{
+    message_writer Request(service_op::op_create_order);
+    Request.integer((int32_t)Items.size());
+    for (const order_input& Input : Items)
+    {
+        Request.integer(Input.ItemID).integer(Input.Quantity);
+    }
+    return _Call(Request, OrderNumber);
+}
+
+bool RemoteAddItemToOrder(int OrderNumber, int ItemID, int ItemQuantity)
+{
+    message_writer Request(service_op::op_add_item_to_order);
+    Request.integer(OrderNumber).integer(ItemID).integer(ItemQuantity);
+    return _Call(Request);
+}
+
+bool RemoteUpdateOrderItem(int OrderNumber, int ItemID, int Quantity)
+{
+    message_writer Request(service_op::op_update_order_item);
+    Request.integer(OrderNumber).integer(ItemID).integer(Quantity);
+    return _Call(Request);
+}
+
+bool RemoteDeleteOrderItem(int OrderNumber, int ItemID)
+{
+    message_writer Request(service_op::op_delete_order_item);
+    Request.integer(OrderNumber).integer(ItemID);
+    return _Call(Request);
+}
+
+bool RemoteDeleteOrder(int OrderNumber, delete_counts* Counts)
+{
+    message_writer Request(service_op::op_delete_order);
+    Request.integer(OrderNumber);
+    return _Call(Request, nullptr, Counts);
+}
+
+static void _WriteKeys(message_writer& Request, const std::vector<int>& Keys)
+{
+    Request.integer((int32_t)Keys.size());
+    for (int Key : Keys)
+    {
+        Request.integer(Key);
+    }
+}
+
+bool RemoteDeleteOrders(const std::vector<int>& OrderNumbers,
+                        delete_counts* Counts)
+{
+    message_writer Request(service_op::op_delete_orders);
+    _WriteKeys(Request, OrderNumbers);
+    return _Call(Request, nullptr, Counts);
+}
+
+bool RemoteDeleteOrdersByDate(const char* From, const char* To,
+                              delete_counts* Counts)
+{
+    message_writer Request(service_op::op_delete_orders_by_date);
+    Request.text(From).text(To);
+    return _Call(Request, nullptr, Counts);
+}
+
+// The local catalogue is dropped after every item or supply write, like the
+// local versions do, so the next lookup reads what the service wrote
+bool RemoteCreateItem(const char* ItemName, const char* ItemDescription,
+                      double ItemPrice,
+                      const std::vector<ingredient>& Ingredients,
+                      int64_t* ItemID)
+{
+    message_writer Request(service_op::op_create_item);
+    Request.text(ItemName).text(ItemDescription).decimal(ItemPrice);
+    Request.integer((int32_t)Ingredients.size());
+    for (const ingredient& Ingredient : Ingredients)
+    {
+        Request.integer(Ingredient.SupplyID).decimal(Ingredient.Quantity);
+    }
+
+    bool Result = _Call(Request, ItemID);
+    InvalidateCatalog();
+    return Result;
+}
+
+bool RemoteDeleteItem(int ItemID, delete_counts* Counts)
+{
+    message_writer Request(service_op::op_delete_item);
+    Request.integer(ItemID);
+
+    bool Result = _Call(Request, nullptr, Counts);
+    InvalidateCatalog();
+    return Result;
+}
+
+bool RemoteDeleteItems(const std::vector<int>& ItemIDs, delete_counts* Counts)
+{
+    message_writer Request(service_op::op_delete_items);
+    _WriteKeys(Request, ItemIDs);
+
+    bool Result = _Call(Request, nullptr, Counts);
+    InvalidateCatalog();
+    return Result;
+}
+
+bool RemoteUpdateIngredient(int ItemID, int SupplyID, double Quantity)
+{
+    message_writer Request(service_op::op_update_ingredient);
+    Request.integer(ItemID).integer(SupplyID).decimal(Quantity);
+
+    bool Result = _Call(Request);
+    InvalidateCatalog();
+    return Result;
+}
+
+bool RemoteDeleteIngredient(int ItemID, int SupplyID)
+{
+    message_writer Request(service_op::op_delete_ingredient);
+    Request.integer(ItemID).integer(SupplyID);
+
+    bool Result = _Call(Request);
+    InvalidateCatalog();
+    return Result;
+}
+
+bool RemoteCreateSupply(const char* SupplyName, const char* UnitName,
+                        int Quantity, int64_t* SupplyID)
+{
+    message_writer Request(service_op::op_create_supply);
+    Request.text(SupplyName).text(UnitName).integer(Quantity);
+
+    bool Result = _Call(Request, SupplyID);
+    InvalidateCatalog();
+    return Result;
+}
@@ -0,0 +1,89 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: service.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Serve the database writes to other registers over a Unix socket
+ */
+
+#pragma once
+
+#include "database.hpp"
+#include "order_writer.hpp"
+#include <stdint.h>
+#include <vector>
+
+/*
+ * One process owns the writes to books_and_brews.db and handles them one at
+ * a time on its own connection, so registers queue on a socket instead of
+ * retrying on SQLite's write lock. Clients still read through their own
+ * connection, which WAL lets run alongside the service's writes.
+ *
+ * Every message is a frame, a uint32_t payload size and then the payload, in
+ * host byte order since both ends are on the same machine. A request is a
+ * service_op byte and its arguments. A reply is an ok byte, an int64_t result
+ * (the ID of a created row), the four delete_counts and then a count byte
+ * and the messages the service logged while handling the request. Text is a
+ * uint16_t length including the terminator, 0 for nullptr, and the bytes.
+ */
+
+#define BB_SERVICE_PROTOCOL_VERSION 1
+#define BB_SERVICE_MAX_FRAME (1 << 20)
+
+enum class service_op : uint8_t
+{
+    op_hello, // Protocol version, must be the first request
+    op_create_order,
+    op_add_item_to_order,
+    op_update_order_item,
+    op_delete_order_item,
+    op_delete_order,
+    op_delete_orders,
+    op_delete_orders_by_date,
+    op_create_item,
+    op_delete_item,
+    op_delete_items,
+    op_update_ingredient,
+    op_delete_ingredient,
+    op_create_supply
+};
+
+// Serves requests until SIGINT or SIGTERM, after DatabaseInit(). A socket
+// file left behind by a service that is no longer running is replaced.
+// Requests run on an order writer thread started with Options, and orders
+// from different clients arriving within its window share one commit.
+bool RunOrderService(const char* SocketPath,
+                     const order_writer_options& Options);
+
+// While connected every database.hpp write is sent to the service, with the
+// same result and logging as running it locally. Transaction(), Commit() and
+// Rollback() do nothing, each write commits in the service on its own.
+bool ConnectOrderService(const char* SocketPath);
+void DisconnectOrderService();
+bool OrderServiceConnected();
+
+// Client halves of the forwarded writes, called by database.cpp
+bool RemoteCreateOrder(const std::vector<order_input>& Items,
+                       int64_t* OrderNumber);
+bool RemoteAddItemToOrder(int OrderNumber, int ItemID, int ItemQuantity);
+bool RemoteUpdateOrderItem(int OrderNumber, int ItemID, int Quantity);
+bool RemoteDeleteOrderItem(int OrderNumber, int ItemID);
+bool RemoteDeleteOrder(int OrderNumber, delete_counts* Counts);
+bool RemoteDeleteOrders(const std::vector<int>& OrderNumbers,
+                        delete_counts* Counts);
+bool RemoteDeleteOrdersByDate(const char* From, const char* To,
+                              delete_counts* Counts);
+bool RemoteCreateItem(const char* ItemName, const char* ItemDescription,
+                      double ItemPrice,
+                      const std::vector<ingredient>& Ingredients,
+                      int64_t* ItemID);
+bool RemoteDeleteItem(int ItemID, delete_counts* Counts);
+bool RemoteDeleteItems(const std::vector<int>& ItemIDs, delete_counts* Counts);
+bool RemoteUpdateIngredient(int ItemID, int SupplyID, double Quantity);
+bool RemoteDeleteIngredient(int ItemID, int SupplyID);
+bool RemoteCreateSupply(const char* SupplyName, const char* UnitName,
+                        int Quantity, int64_t* SupplyID);
@@ -0,0 +1,59 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: terminal.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Compose each menu screen in memory and draw it in one write.
+ */
+
+#include "terminal.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static char S_ScreenBuffer[BB_SCREEN_BUFFER_SIZE];
+static bool S_AnsiTerminal = false;
+
+void TerminalInit()
+{
+#ifndef _WIN32
+    const char* Term = getenv("TERM");
+    S_AnsiTerminal = isatty(STDOUT_FILENO) && Term != nullptr &&
+                     *Term != '\0' && strcmp(Term, "dumb") != 0;
+#endif
+
+    // stdout itself is the screen buffer, so the menus keep using printf and
+    // a screen only costs a write when it is presented.
+    setvbuf(stdout, S_ScreenBuffer, _IOFBF, sizeof(S_ScreenBuffer));
+}
+
+void ClearScreen()
+{
+#ifdef _WIN32
+    PresentScreen();
+    system("cls");
+#else
+    if (S_AnsiTerminal)
+    {
+        // Cursor home, clear the screen, clear the scrollback
+        fputs("\x1b[H\x1b[2J\x1b[3J", stdout);
+    }
+    else
+    {
+        // Dumb terminals and pipes can't be redrawn, so screens scroll
+        fputs("\n", stdout);
+    }
+#endif
+}
+
+void PresentScreen()
+{
+    fflush(stdout);
+}
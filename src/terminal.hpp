@@ -0,0 +1,25 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: terminal.hpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Compose each menu screen in memory and draw it in one write.
+ */
+
+#pragma once
+
+#define BB_SCREEN_BUFFER_SIZE (64 * 1024)
+
+// Must run before anything is printed to stdout. Until then ClearScreen
+// behaves as on a dumb terminal and output is not batched.
+void TerminalInit();
+
+// Starts a new screen. Everything printed afterwards is held in the screen
+// buffer until PresentScreen, so the clear and the new contents reach the
+// terminal together.
+void ClearScreen();
+void PresentScreen();
@@ -0,0 +1,115 @@
+/*
+ * -------------------------------
+ * Copyright (C) 2025 Connor Taylor.
+ * Released under the MIT License.
+ * -------------------------------
+ *
+ * Program name: reader_test.cpp
+ * Author: Connor Taylor
+ * Last Update: 10/16/2025
+ * Purpose: Check that reads on the reader pool run while a write transaction
+ * is open, and that the writer's own thread still sees what it wrote.
+ */
+
+#include "database.hpp"
+#include "logger.hpp"
+#include "scratch.hpp"
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+
+static int S_Failures;
+
+static void _Check(bool Condition, const char* What)
+{
+    printf("%s: %s\n", Condition ? "ok  " : "FAIL", What);
+    S_Failures += !Condition;
+}
+
+// Orders seen by a pager, counting every page
+static int _CountOrders()
+{
+    int Orders = 0;
+    keyset_pager Pager = GetOrderPreviewPager();
+    SetPageSize(Pager, 100);
+    FetchPage(Pager);
+    while (StepPage(Pager))
+    {
+        Orders++;
+    }
+    ClosePager(Pager);
+    return Orders;
+}
+
+int main()
+{
+    const char DatabaseFile[] = "bb_reader_test.db";
+    if (!CreateScratchDatabase(DatabaseFile, BB_SCHEMA_FILE) ||
+        !DatabaseInit(DatabaseFile, RegisterProfile))
+    {
+        return 1;
+    }
+
+    LoggerInit(CreateLogger("B&B Test Logs", 5));
+
+    int64_t SupplyID, ItemID;
+    bool Result = CreateSupply("Beans", "g", 1000, &SupplyID) &&
+                  CreateItem("Espresso", "Short", 2.5,
+                             {{.SupplyID = (int)SupplyID, .Quantity = 1}},
+                             &ItemID);
+    std::vector<order_input> Items = {{.ItemID = (int)ItemID, .Quantity = 1}};
+    Result = Result && CreateOrder(Items);
+    _Check(Result, "committed one order");
+
+    // The second order stays uncommitted while the reads below run
+    Transaction();
+    _Check(CreateOrder(Items), "created a second order in a transaction");
+
+    {
+        reader_lease Own;
+        _Check(!Own, "no lease inside the thread's own write transaction");
+        _Check(GetOrderCount() == 2, "the writer's thread sees its order");
+        _Check(_CountOrders() == 2, "the writer's thread pages its order");
+    }
+
+    int Leased = -1, Paged = -1;
+    double Seconds = 0;
+    std::thread Reader([&]() {
+        auto Start = std::chrono::steady_clock::now();
+        {
+            reader_lease Lease;
+            if (Lease)
+            {
+                Leased = GetOrderCount();
+            }
+        }
+        Paged = _CountOrders();
+        Seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - Start)
+                      .count();
+    });
+    Reader.join();
+
+    _Check(Leased == 1, "a leased read sees only the committed order");
+    _Check(Paged == 1, "a pager on another thread sees only the committed "
+                       "order");
+    _Check(Seconds < 1.0, "the reads did not wait for the writer");
+
+    Commit();
+
+    std::thread After([&]() {
+        reader_lease Lease;
+        Leased = Lease ? GetOrderCount() : -1;
+    });
+    After.join();
+    _Check(Leased == 2, "a leased read sees the order once committed");
+
+    if (S_Failures > 0)
+    {
+        PrintLogs();
+    }
+
+    DatabaseClose();
+    FreeLogger();
+    return S_Failures == 0 ? 0 : 1;
+}